@@ -0,0 +1,182 @@
+"""Generates synthetic submissions for benchmarking the linter.
+
+Every kind of submission stresses a different part of the checkers:
+
+  long_main         one huge main function full of loops and expressions
+  many_functions    thousands of small functions
+  heavy_templates   deep template recursion and nested standard containers
+  literal_table     huge constant tables, i.e. long lines and big initializers
+  commented_couts   many commented out debug prints
+
+Each kind is generated at several sizes. The output is deterministic, so
+results of different releases are comparable.
+
+Usage: python3 bench/gen_corpus.py [--out DIR] [--sizes 1000,10000]
+                                   [--files-per-size N]
+"""
+
+import argparse
+import os
+import random
+
+PROLOGUE = '#include <bits/stdc++.h>\nusing namespace std;\n\n'
+
+FAST_IO = '  ios_base::sync_with_stdio(false); cin.tie(NULL);\n'
+
+
+def long_main(rng, size):
+    lines = ['int main() {', FAST_IO.rstrip('\n'), '  long long n, acc = 0;',
+             '  cin >> n;', '  vector<long long> v(n);']
+    while len(lines) < size:
+        k = rng.randint(1, 1000)
+        choice = rng.randint(0, 3)
+        if choice == 0:
+            lines.append('  for (int i = 0; i < n; ++i) {')
+            lines.append('    acc += v[i] * {0} % 1000000007;'.format(k))
+            lines.append('  }')
+        elif choice == 1:
+            lines.append('  if (acc % {0} == 0) acc /= 2; else acc += {0};'
+                         .format(k))
+        elif choice == 2:
+            lines.append('  while (acc > {0}) acc -= {0};'.format(k))
+        else:
+            lines.append('  acc = max(acc, (long long){0}) ^ (acc << 1);'
+                         .format(k))
+    lines.append('  cout << acc << endl;')
+    lines.append('}')
+    return '\n'.join(lines) + '\n'
+
+
+def many_functions(rng, size):
+    lines = []
+    count = max(1, size // 5)
+    for i in range(count):
+        lines.append('int f{0}(int x) {{'.format(i))
+        lines.append('  int y = x * {0} + {1};'.format(rng.randint(1, 99), i))
+        lines.append('  return y % 1000 + (x > {0} ? f{1}(x - 1) : 0);'
+                     .format(rng.randint(1, 99), max(0, i - 1)))
+        lines.append('}')
+        lines.append('')
+    lines.append('int main() {')
+    lines.append(FAST_IO.rstrip('\n'))
+    lines.append('  int s = 0;')
+    for i in range(0, count, max(1, count // 100)):
+        lines.append('  s += f{0}({1});'.format(i, rng.randint(1, 10)))
+    lines.append('  cout << s << endl;')
+    lines.append('}')
+    return '\n'.join(lines) + '\n'
+
+
+def heavy_templates(rng, size):
+    lines = [
+        'template <int N> struct Fib {',
+        '  static constexpr long long value = Fib<N - 1>::value + '
+        'Fib<N - 2>::value;',
+        '};',
+        'template <> struct Fib<0> { static constexpr long long value = 0; };',
+        'template <> struct Fib<1> { static constexpr long long value = 1; };',
+        '',
+        'template <typename T, typename U>',
+        'T combine(const T &a, const U &b) { return a + T(b.size()); }',
+        '',
+    ]
+    i = 0
+    while len(lines) < size:
+        depth = rng.randint(10, 80)
+        lines.append('map<pair<int, vector<long long>>, set<string>> m{0};'
+                     .format(i))
+        lines.append('long long t{0} = Fib<{1}>::value;'.format(i, depth))
+        lines.append('auto c{0} = combine(t{0}, vector<map<int, int>>({1}));'
+                     .format(i, rng.randint(1, 9)))
+        lines.append('')
+        i += 1
+    lines.append('int main() {')
+    lines.append(FAST_IO.rstrip('\n'))
+    lines.append('  cout << t0 << endl;')
+    lines.append('}')
+    return '\n'.join(lines) + '\n'
+
+
+def literal_table(rng, size):
+    lines = ['const int table[] = {']
+    per_line = 40
+    while len(lines) < size:
+        lines.append('  ' + ', '.join(str(rng.randint(0, 10 ** 9))
+                                      for _ in range(per_line)) + ',')
+    lines.append('};')
+    lines.append('const char *names[] = {')
+    for i in range(min(size // 10, 1000)):
+        lines.append('  "name_{0}_\\"quoted\\" // not a comment",'.format(i))
+    lines.append('};')
+    lines.append('')
+    lines.append('int main() {')
+    lines.append(FAST_IO.rstrip('\n'))
+    lines.append('  cout << table[0] << names[0] << endl;')
+    lines.append('}')
+    return '\n'.join(lines) + '\n'
+
+
+def commented_couts(rng, size):
+    lines = ['int main() {', FAST_IO.rstrip('\n'), '  int x = 0;']
+    while len(lines) < size:
+        k = rng.randint(0, 3)
+        if k == 0:
+            lines.append('  // cout << "x = " << x << endl;')
+        elif k == 1:
+            lines.append('  /* cout << x; */ x += {0};'
+                         .format(rng.randint(1, 9)))
+        elif k == 2:
+            lines.append('  x ^= {0}; // cerr << x;'.format(rng.randint(1, 9)))
+        else:
+            lines.append('  // just a comment about {0}'
+                         .format(rng.randint(1, 9)))
+    lines.append('  cout << x << endl;')
+    lines.append('}')
+    return '\n'.join(lines) + '\n'
+
+
+KINDS = [
+    ('long_main', long_main),
+    ('many_functions', many_functions),
+    ('heavy_templates', heavy_templates),
+    ('literal_table', literal_table),
+    ('commented_couts', commented_couts),
+]
+
+DEFAULT_SIZES = [100, 1000, 10000]
+
+
+def generate(out, sizes=DEFAULT_SIZES, files_per_size=3):
+    """Writes the corpus to out and returns [(kind, size, path)]."""
+    if not os.path.isdir(out):
+        os.makedirs(out)
+    files = []
+    for kind, generator in KINDS:
+        for size in sizes:
+            for index in range(files_per_size):
+                rng = random.Random('{0}-{1}-{2}'.format(kind, size, index))
+                path = os.path.join(
+                    out, '{0}_{1}_{2}.cc'.format(kind, size, index))
+                with open(path, 'w') as f:
+                    f.write(PROLOGUE + generator(rng, size))
+                files.append((kind, size, path))
+    return files
+
+
+def parse_sizes(text):
+    return [int(size) for size in text.split(',') if size]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--out', default='build/bench/corpus')
+    parser.add_argument('--sizes', type=parse_sizes, default=DEFAULT_SIZES,
+                        help='comma separated line counts')
+    parser.add_argument('--files-per-size', type=int, default=3)
+    args = parser.parse_args()
+    files = generate(args.out, args.sizes, args.files_per_size)
+    print('Generated {0} files in {1}'.format(len(files), args.out))
+
+
+if __name__ == '__main__':
+    main()
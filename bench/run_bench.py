@@ -0,0 +1,230 @@
+"""Times the linter plugins on a generated corpus of submissions.
+
+Every plugin is run alone, then plugin_competitive_lint.so runs all checks
+together, and a run without any plugin gives the cost of parsing alone. For
+each configuration the throughput (files/s, lines/s) and the p50/p99 latency
+of a single file are reported, overall and per kind of submission.
+
+The results are written as JSON (build/bench/results.json by default), so the
+numbers of different releases can be compared.
+
+Execute from the project root after building, e.g. through "make bench":
+
+  python3 bench/run_bench.py [--sizes 100,1000] [--repeat 3]
+                             [--only goto,competitive_lint]
+"""
+
+import argparse
+import json
+import os
+import platform
+import subprocess
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import gen_corpus
+
+PLUGINS = [
+    'goto',
+    'floating_point_comp',
+    'no_float',
+    'consecutive_newlines',
+    'fast_cin',
+    'debug_macro',
+    'flush_in_loop',
+    'container_by_value',
+    'deep_recursion',
+    'linear_in_loop',
+    'integer_math',
+    'alloc_in_loop',
+    'input_volume',
+    'competitive_lint',
+]
+
+# Configuration without any plugin: the cost of the compiler alone.
+BASELINE = 'parse_only'
+
+# What clang prints when the plugin of a configuration doesn't run. The exit
+# status doesn't tell, as the checkers report errors too.
+PLUGIN_ERRORS = [
+    'unable to load plugin',
+    'unable to find plugin',
+    'unknown plugin',
+]
+
+
+def read_llvm_bin_path():
+    with open('build/_build_config') as f:
+        return f.read().strip()
+
+
+def plugin_args(plugin):
+    if plugin == BASELINE:
+        return []
+    return ['-Xclang', '-load',
+            '-Xclang', 'build/plugin_{0}.so'.format(plugin),
+            '-Xclang', '-add-plugin', '-Xclang', plugin]
+
+
+def percentile(sorted_values, fraction):
+    if not sorted_values:
+        return 0.0
+    index = int(round(fraction * (len(sorted_values) - 1)))
+    return sorted_values[index]
+
+
+def summarize(samples):
+    """samples: [(lines, seconds)]"""
+    latencies = sorted(seconds for _, seconds in samples)
+    total = sum(latencies)
+    lines = sum(lines for lines, _ in samples)
+    return {
+        'files': len(samples),
+        'lines': lines,
+        'seconds': round(total, 6),
+        'files_per_second': round(len(samples) / total, 3) if total else 0,
+        'lines_per_second': round(lines / total, 1) if total else 0,
+        'p50_ms': round(percentile(latencies, 0.50) * 1000, 3),
+        'p99_ms': round(percentile(latencies, 0.99) * 1000, 3),
+    }
+
+
+def check_plugin(command):
+    """Runs command once and returns why its timings would be invalid: the
+    plugin wasn't loaded or clang crashed. Returns None if they are valid."""
+    process = subprocess.run(command, stdout=subprocess.DEVNULL,
+                             stderr=subprocess.PIPE)
+    if process.returncode < 0:
+        return 'clang was killed by signal {0}'.format(-process.returncode)
+    stderr = process.stderr.decode('utf-8', 'replace')
+    for line in stderr.split('\n'):
+        if any(error in line for error in PLUGIN_ERRORS):
+            return line.strip()
+    return None
+
+
+def time_file(command):
+    start = time.perf_counter()
+    # Diagnostics are expected, only the time matters.
+    returncode = subprocess.call(command, stdout=subprocess.DEVNULL,
+                                 stderr=subprocess.DEVNULL)
+    seconds = time.perf_counter() - start
+    if returncode < 0:
+        raise RuntimeError('clang was killed by signal {0}: {1}'.format(
+            -returncode, ' '.join(command)))
+    return seconds
+
+
+def count_lines(path):
+    with open(path) as f:
+        return sum(1 for _ in f)
+
+
+def clang_version(clang):
+    output = subprocess.check_output([clang, '--version'])
+    return output.decode('utf-8', 'replace').split('\n')[0]
+
+
+def git_revision():
+    try:
+        output = subprocess.check_output(['git', 'rev-parse', 'HEAD'],
+                                         stderr=subprocess.DEVNULL)
+        return output.decode('utf-8').strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def print_table(results):
+    header = '{0:<22} {1:>7} {2:>10} {3:>12} {4:>10} {5:>10}'
+    print(header.format('configuration', 'files', 'files/s', 'lines/s',
+                        'p50 ms', 'p99 ms'))
+    for name, result in results.items():
+        total = result['total']
+        print(header.format(name, total['files'], total['files_per_second'],
+                            total['lines_per_second'], total['p50_ms'],
+                            total['p99_ms']))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--corpus', default='build/bench/corpus')
+    parser.add_argument('--sizes', type=gen_corpus.parse_sizes,
+                        default=gen_corpus.DEFAULT_SIZES,
+                        help='comma separated line counts')
+    parser.add_argument('--files-per-size', type=int, default=3)
+    parser.add_argument('--repeat', type=int, default=1,
+                        help='times every file is linted')
+    parser.add_argument('--only', default='',
+                        help='comma separated plugins to run')
+    parser.add_argument('--output', default='build/bench/results.json')
+    args = parser.parse_args()
+
+    if not os.path.isdir('build') or not os.path.exists('build/_build_config'):
+        print('ERROR: Please execute from the project root directory.')
+        print('.....  And build the plugins first.')
+        return 1
+
+    clang = os.path.join(read_llvm_bin_path(), 'clang++')
+    files = gen_corpus.generate(args.corpus, args.sizes, args.files_per_size)
+    lines = dict((path, count_lines(path)) for _, _, path in files)
+
+    configurations = [BASELINE] + PLUGINS
+    if args.only:
+        configurations = [name for name in args.only.split(',') if name]
+
+    # Without its plugin a configuration would be timed as parsing alone, and
+    # those numbers would be recorded as its results.
+    for name in configurations:
+        command = [clang, '-fsyntax-only'] + plugin_args(name) + [files[0][2]]
+        error = check_plugin(command)
+        if error:
+            print('ERROR: {0} is not valid: {1}'.format(name, error))
+            return 1
+
+    results = {}
+    for name in configurations:
+        samples = []
+        by_kind = {}
+        for kind, _, path in files:
+            command = [clang, '-fsyntax-only'] + plugin_args(name) + [path]
+            for _ in range(args.repeat):
+                try:
+                    sample = (lines[path], time_file(command))
+                except RuntimeError as error:
+                    print('\nERROR: {0}'.format(error))
+                    return 1
+                samples.append(sample)
+                by_kind.setdefault(kind, []).append(sample)
+        results[name] = {
+            'total': summarize(samples),
+            'kinds': dict((kind, summarize(kind_samples))
+                          for kind, kind_samples in by_kind.items()),
+        }
+        sys.stdout.write('.')
+        sys.stdout.flush()
+    print('')
+
+    report = {
+        'timestamp': int(time.time()),
+        'revision': git_revision(),
+        'clang': clang_version(clang),
+        'host': platform.node(),
+        'sizes': args.sizes,
+        'files_per_size': args.files_per_size,
+        'repeat': args.repeat,
+        'results': results,
+    }
+    output_dir = os.path.dirname(args.output)
+    if output_dir and not os.path.isdir(output_dir):
+        os.makedirs(output_dir)
+    with open(args.output, 'w') as f:
+        json.dump(report, f, indent=2, sort_keys=True)
+
+    print_table(results)
+    print('Results written to {0}'.format(args.output))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,24 @@
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+int seen[100000];
+
+int main() {
+   int t, n;
+   cin >> t >> n;
+   vector<string> words(n);
+   while (t--) {
+      vector<int> count(n);
+      string name;
+      memset(seen, 0, sizeof(seen));
+      for (int i = 0; i < n; ++i) {
+         vector<int> row(n, 0);
+         string label = "row";
+         for (string word : words) cout << word;
+         memset(seen, 0, sizeof seen);
+      }
+   }
+}
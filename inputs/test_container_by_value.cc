@@ -0,0 +1,31 @@
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+using namespace std;
+
+int dfs(int u, vector<vector<int>> g, vector<bool> &seen) {
+   seen[u] = true;
+   int size = 1;
+   for (int v : g[u]) {
+      if (!seen[v]) size += dfs(v, g, seen);
+   }
+   return size;
+}
+
+int count(string s, map<int, int> m);
+
+int count(string s, map<int, int> m) {
+   return s.size() + m.count(0);
+}
+
+void sorted(vector<int> a) {
+   sort(a.begin(), a.end());
+}
+
+int main() {
+   vector<vector<int>> g(3);
+   vector<bool> seen(3);
+   dfs(0, g, seen);
+   count("", map<int, int>());
+}
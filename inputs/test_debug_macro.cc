@@ -54,5 +54,8 @@ int main()
         }
         //cout << "Sum is " << sum << endl;
     }
+    // printf("%d\n", sum);
+    /* cerr << "n = " << n << endl;
+       cerr << "sum = " << sum << endl; */
     cout << sum + 1 << endl;
 }
\ No newline at end of file
@@ -0,0 +1,39 @@
+#include <algorithm>
+#include <vector>
+using namespace std;
+
+vector<int> g[100000];
+
+int dfs(int u, int p) {
+   int children[64] = {};
+   int count = 0;
+   for (int v : g[u]) {
+      if (v != p) children[count++ % 64] = dfs(v, u);
+   }
+   return count;
+}
+
+void odd(int n);
+
+void even(int n) {
+   long long memo[100];
+   if (n > 0) odd(n - 1);
+}
+
+void odd(int n) {
+   if (n > 0) even(n - 1);
+}
+
+int depth(int u, int p) {
+   int best = 0;
+   for (int v : g[u]) {
+      if (v != p) best = max(best, depth(v, u) + 1);
+   }
+   return best;
+}
+
+int main() {
+   dfs(0, -1);
+   even(10);
+   depth(0, -1);
+}
@@ -1,7 +1,17 @@
+#include <cstdio>
 #include <iostream>
 using namespace std;
 
+void init() {
+   ios_base::sync_with_stdio(false);
+}
+
 int main() {
+   cout.tie(0); cin.tie(0)->sync_with_stdio(false);
    ios_base::sync_with_stdio(false); cin.tie(NULL);
   
+   init(); cin.tie(NULL);
+   int n;
+   cin >> n;
+   printf("%d\n", n);
 }
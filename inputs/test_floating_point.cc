@@ -1,6 +1,12 @@
 #include <iostream>
 using namespace std;
 
+typedef long double real;
+
+bool same(const float x, real y) {
+    return x != y;
+}
+
 int main() {
 	float a, b;
     cin >> a >> b;
@@ -0,0 +1,23 @@
+#include <cstdio>
+#include <iostream>
+using namespace std;
+
+void print(int x) {
+   cout << x << endl;
+}
+
+int main() {
+   int n;
+   cin >> n;
+   for (int i = 0; i < n; ++i) {
+      cout << i << endl;
+      cerr << i << endl;
+      print(i);
+   }
+   while (n--) {
+      printf("%d\n", n);
+      fflush(stdout);
+      cout.flush();
+   }
+   cout << n << endl;
+}
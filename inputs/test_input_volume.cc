@@ -0,0 +1,21 @@
+#include <cstdio>
+#include <iostream>
+using namespace std;
+
+int grid[1000][1000];
+
+int main() {
+   ios_base::sync_with_stdio(false);
+   cin.tie(NULL);
+   int t;
+   cin >> t;
+   while (t--) {
+      int n, m;
+      cin >> n >> m;
+      for (int i = 0; i < n; ++i) {
+         for (int j = 0; j < m; ++j) {
+            cin >> grid[i][j];
+         }
+      }
+   }
+}
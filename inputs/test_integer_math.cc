@@ -0,0 +1,17 @@
+#include <cmath>
+#include <iostream>
+using namespace std;
+
+int main() {
+   int n, k;
+   cin >> n >> k;
+   long long power = pow(2, k);
+   int square = (int)pow(n, 2);
+   long long big = pow(n, k);
+   int root = sqrt(n);
+   int bits = log2(n);
+   long long wide = n;
+   int wideBits = log2(wide);
+   double exact = sqrt(n);
+   cout << power << square << big << root << bits << wideBits << exact;
+}
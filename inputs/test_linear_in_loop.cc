@@ -0,0 +1,25 @@
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+int main() {
+   int n;
+   cin >> n;
+   vector<int> v(n);
+   string s;
+   for (int i = 0; i < n; ++i) {
+      v.insert(v.begin(), i);
+      s = s + 'a';
+      s = (s + 'c');
+      for (int j = 0; j < n; ++j) {
+         if (find(v.begin(), v.end(), j) != v.end()) cout << count(v.begin(), v.end(), j);
+      }
+   }
+   while (!v.empty()) {
+      v.erase(v.begin());
+   }
+   v.erase(v.begin(), v.end());
+   s = s + "b";
+}
@@ -9,6 +9,11 @@ int x(float f) {
   return (int)f;
 }
 
+typedef float real;
+const float EPS = 1e-6f;
+float table[10][10];
+real y;
+
 int main() {
 	float a, b;
     int c;
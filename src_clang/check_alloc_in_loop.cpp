@@ -0,0 +1,190 @@
+//------------------------------------------------------------------------------
+// Checks for containers constructed on every iteration of a loop, e.g.
+// vector<int> cnt(n) in the body, and for memset clearing a whole large
+// array on every iteration. Both cost time proportional to the size on every
+// iteration; a container declared before the loop keeps its memory when it
+// is reused with clear() or assign().
+//
+// One loop is often the loop over the test cases, so only nests of depth two
+// or more are reported as errors, the others as warnings.
+//------------------------------------------------------------------------------
+#include "clang/AST/AST.h"
+#include "clang/Basic/Diagnostic.h"
+
+#include "llvm/ADT/StringSwitch.h"
+
+#include "checker.h"
+
+namespace complint {
+namespace {
+
+using namespace clang;
+
+// Strings up to this length are stored without allocating.
+constexpr unsigned SHORT_STRING_LENGTH = 15;
+
+enum class Allocation { None, WithArguments, Always };
+
+// Whether constructing the standard container type allocates: always for
+// the containers built on deque, otherwise once there is something to store.
+Allocation getAllocation(QualType type) {
+  const CXXRecordDecl *record = type.getCanonicalType()->getAsCXXRecordDecl();
+  if (!record || !record->getIdentifier() || !record->isInStdNamespace()) {
+    return Allocation::None;
+  }
+  return StringSwitch<Allocation>(record->getName())
+      .Cases("deque", "queue", "stack", Allocation::Always)
+      .Cases("vector", "basic_string", "list", "forward_list",
+             Allocation::WithArguments)
+      .Cases("map", "multimap", "set", "multiset", Allocation::WithArguments)
+      .Cases("unordered_map", "unordered_multimap", "unordered_set",
+             "unordered_multiset", Allocation::WithArguments)
+      .Cases("priority_queue", "valarray", Allocation::WithArguments)
+      .Default(Allocation::None);
+}
+
+// Whether the initializer of a container stores something in it, rather
+// than only default arguments or a short string literal.
+bool hasContents(const Expr *init) {
+  if (const auto *cleanups = dyn_cast<ExprWithCleanups>(init)) {
+    init = cleanups->getSubExpr();
+  }
+  const auto *construct = dyn_cast<CXXConstructExpr>(init);
+  if (!construct) {
+    return true;
+  }
+  unsigned explicitArgs = 0;
+  for (const Expr *arg : construct->arguments()) {
+    if (!isa<CXXDefaultArgExpr>(arg)) {
+      ++explicitArgs;
+    }
+  }
+  if (explicitArgs == 1) {
+    const auto *literal =
+        dyn_cast<StringLiteral>(construct->getArg(0)->IgnoreParenImpCasts());
+    if (literal && literal->getLength() <= SHORT_STRING_LENGTH) {
+      return false;
+    }
+  }
+  return explicitArgs > 0;
+}
+
+class AllocInLoopChecker : public Checker {
+public:
+  StringRef getName() const override { return "alloc_in_loop"; }
+
+  void registerDiagnostics(DiagnosticRegistry &registry) override {
+    StringRef allocation =
+        "The container is allocated on every iteration of a loop nest of "
+        "depth %0. Declare it before the loops and reuse it with clear() or "
+        "assign().";
+    StringRef memset =
+        "memset clears all %1 bytes of the array on every iteration of a "
+        "loop nest of depth %0. Clear only the part which was used.";
+    allocationWarningID =
+        registry.add(*this, DiagnosticsEngine::Warning, allocation);
+    allocationErrorID =
+        registry.add(*this, DiagnosticsEngine::Error, allocation);
+    memsetWarningID = registry.add(*this, DiagnosticsEngine::Warning, memset);
+    memsetErrorID = registry.add(*this, DiagnosticsEngine::Error, memset);
+  }
+
+  bool setOption(StringRef name, StringRef value) override {
+    return name == "min_memset_bytes" &&
+           !value.getAsInteger(10, minMemsetBytes);
+  }
+
+  void visitStmt(const Stmt *stmt, const TraversalContext &context) override {
+    if (const auto *declStmt = dyn_cast<DeclStmt>(stmt)) {
+      visitDeclStmt(declStmt, context);
+    } else if (const auto *call = dyn_cast<CallExpr>(stmt)) {
+      visitCall(call, context);
+    }
+  }
+
+private:
+  unsigned allocationWarningID = 0;
+  unsigned allocationErrorID = 0;
+  unsigned memsetWarningID = 0;
+  unsigned memsetErrorID = 0;
+  uint64_t minMemsetBytes = 4096;
+
+  static bool isInMainFile(SourceLocation location,
+                           const TraversalContext &context) {
+    const SourceManager &sourceManager =
+        context.getASTContext().getSourceManager();
+    return sourceManager.isInMainFile(sourceManager.getExpansionLoc(location));
+  }
+
+  void visitDeclStmt(const DeclStmt *declStmt,
+                     const TraversalContext &context) {
+    // The variable of a range-based for loop is a copy of an element, not a
+    // container to hoist.
+    auto stack = context.getStmtStack();
+    if (stack.size() >= 2 && isa<CXXForRangeStmt>(stack[stack.size() - 2])) {
+      return;
+    }
+    unsigned depth = 0;
+    for (const Decl *decl : declStmt->decls()) {
+      const auto *var = dyn_cast<VarDecl>(decl);
+      if (!var || !var->hasLocalStorage() || !var->getInit() ||
+          !isInMainFile(var->getLocation(), context)) {
+        continue;
+      }
+      Allocation allocation = getAllocation(var->getType());
+      if (allocation == Allocation::None ||
+          (allocation == Allocation::WithArguments &&
+           !hasContents(var->getInit()))) {
+        continue;
+      }
+      if (depth == 0) {
+        depth = context.getLoopDepth();
+        if (depth == 0) {
+          return;
+        }
+      }
+      context.getDiagnostics().Report(
+          var->getLocation(),
+          depth > 1 ? allocationErrorID : allocationWarningID)
+          << depth;
+    }
+  }
+
+  // memset(a, value, sizeof(a)) for a large array a.
+  void visitCall(const CallExpr *call, const TraversalContext &context) {
+    const FunctionDecl *function = call->getDirectCallee();
+    if (!function || !function->getIdentifier() ||
+        function->getName() != "memset" || call->getNumArgs() != 3 ||
+        !isInMainFile(call->getLocStart(), context)) {
+      return;
+    }
+    const auto *ref =
+        dyn_cast<DeclRefExpr>(call->getArg(0)->IgnoreParenImpCasts());
+    ASTContext &astContext = context.getASTContext();
+    if (!ref || !astContext.getAsConstantArrayType(ref->getType())) {
+      return;
+    }
+    uint64_t arraySize =
+        astContext.getTypeSizeInChars(ref->getType()).getQuantity();
+    llvm::APSInt size;
+    if (arraySize < minMemsetBytes ||
+        !call->getArg(2)->EvaluateAsInt(size, astContext) ||
+        size.getLimitedValue() < arraySize) {
+      return;
+    }
+    unsigned depth = context.getLoopDepth();
+    if (depth > 0) {
+      context.getDiagnostics().Report(
+          call->getLocStart(), depth > 1 ? memsetErrorID : memsetWarningID)
+          << depth << unsigned(arraySize);
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Checker> createAllocInLoopChecker() {
+  return llvm::make_unique<AllocInLoopChecker>();
+}
+
+} // namespace complint
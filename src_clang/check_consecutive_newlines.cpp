@@ -0,0 +1,60 @@
+//------------------------------------------------------------------------------
+// Doesn't permit more than 2 consecutive empty lines.
+//------------------------------------------------------------------------------
+#include "clang/Basic/Diagnostic.h"
+#include "clang/Basic/SourceManager.h"
+
+#include "checker.h"
+
+namespace complint {
+namespace {
+
+using namespace clang;
+
+class ConsecutiveNewlinesChecker : public Checker {
+public:
+  StringRef getName() const override { return "consecutive_newlines"; }
+
+  void registerDiagnostics(DiagnosticRegistry &registry) override {
+    DiagID = registry.add(*this, DiagnosticsEngine::Error,
+                          "Too much new lines.");
+  }
+
+  bool checksSource() const override { return true; }
+
+  bool setOption(StringRef name, StringRef value) override {
+    return name == "max_empty_lines" && !value.getAsInteger(10, maxEmptyLines);
+  }
+
+  void checkSource(DiagnosticsEngine &diagnostics,
+                   SourceManager &sourceManager,
+                   FileID file, const SourceScan &scan) override {
+    auto fileStart = sourceManager.getLocForStartOfFile(file);
+
+    // Every run of empty lines is reported once, at the line break before
+    // it. An empty line only counts if a line break follows it.
+    unsigned emptyLines = 0;
+    for (unsigned line = 1; line < scan.getLineCount(); ++line) {
+      if (!scan.isBlank(line) || !scan.isTerminated(line)) {
+        emptyLines = 0;
+        continue;
+      }
+      if (++emptyLines == maxEmptyLines + 1) {
+        unsigned offset = scan.getLineStart(line - maxEmptyLines) - 1;
+        diagnostics.Report(fileStart.getLocWithOffset(offset), DiagID);
+      }
+    }
+  }
+
+private:
+  unsigned DiagID = 0;
+  unsigned maxEmptyLines = 2;
+};
+
+} // namespace
+
+std::unique_ptr<Checker> createConsecutiveNewlinesChecker() {
+  return llvm::make_unique<ConsecutiveNewlinesChecker>();
+}
+
+} // namespace complint
@@ -0,0 +1,482 @@
+//------------------------------------------------------------------------------
+// Checks for containers passed by value which could be passed by const
+// reference, e.g. the vector<int> parameter of a recursive dfs.
+//
+// A parameter is only reported if none of its uses in the function body can
+// modify or move it. Every use is followed up through the expressions built
+// on it, e.g. g[u].size() or *v.begin(), until it is either clearly read only
+// or may write; anything the check doesn't understand counts as a write.
+// Copies in recursive functions are reported as errors, as they are made on
+// every call, the others as warnings.
+//------------------------------------------------------------------------------
+#include <vector>
+
+#include "clang/AST/AST.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/ASTMatchers/ASTMatchers.h"
+#include "clang/Basic/Diagnostic.h"
+#include "clang/Lex/Lexer.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringSwitch.h"
+
+#include "checker.h"
+
+namespace complint {
+namespace {
+
+using namespace clang;
+using namespace ast_matchers;
+
+constexpr char PARAM_BINDING[] = "param";
+
+bool isContainerType(QualType type) {
+  if (type->isReferenceType() || type->isDependentType()) {
+    return false;
+  }
+  const CXXRecordDecl *record = type.getCanonicalType()->getAsCXXRecordDecl();
+  if (!record || !record->getIdentifier() || !record->isInStdNamespace()) {
+    return false;
+  }
+  return StringSwitch<bool>(record->getName())
+      .Cases("vector", "deque", "list", "forward_list", "basic_string", true)
+      .Cases("set", "multiset", "unordered_set", "unordered_multiset", true)
+      .Cases("map", "multimap", "unordered_map", "unordered_multimap", true)
+      .Cases("queue", "priority_queue", "stack", "valarray", true)
+      .Default(false);
+}
+
+// A standard container, also through typedefs.
+AST_MATCHER(QualType, isCopiedContainer) { return isContainerType(Node); }
+
+// Only the non-const overload of operator[] exists, which inserts.
+bool isMap(QualType type) {
+  const CXXRecordDecl *record =
+      type.getNonReferenceType().getCanonicalType()->getAsCXXRecordDecl();
+  return record && record->getIdentifier() &&
+         (record->getName() == "map" || record->getName() == "unordered_map");
+}
+
+// Non-const methods with a const overload, which the check can follow.
+bool isElementAccessor(StringRef name) {
+  return StringSwitch<bool>(name)
+      .Cases("front", "back", "at", "top", true)
+      .Default(false);
+}
+
+bool isIteratorAccessor(StringRef name) {
+  return StringSwitch<bool>(name)
+      .Cases("begin", "end", "rbegin", "rend", "data", true)
+      .Cases("find", "lower_bound", "upper_bound", true)
+      .Default(false);
+}
+
+// Algorithms which only read through the iterators they are given.
+bool isReadOnlyAlgorithm(const FunctionDecl *function) {
+  if (!function->getIdentifier() || !function->isInStdNamespace()) {
+    return false;
+  }
+  return StringSwitch<bool>(function->getName())
+      .Cases("accumulate", "count", "count_if", "find", "find_if", true)
+      .Cases("min_element", "max_element", "minmax_element", true)
+      .Cases("lower_bound", "upper_bound", "binary_search", true)
+      .Cases("all_of", "any_of", "none_of", "is_sorted", "equal", true)
+      .Cases("distance", "inner_product", true)
+      .Default(false);
+}
+
+bool isConstReferenceOrValue(QualType type) {
+  if (const auto *reference = type->getAs<ReferenceType>()) {
+    return isa<LValueReferenceType>(reference) &&
+           reference->getPointeeType().isConstQualified();
+  }
+  return true;
+}
+
+bool isComparisonOrDifference(OverloadedOperatorKind kind) {
+  switch (kind) {
+  case OO_EqualEqual:
+  case OO_ExclaimEqual:
+  case OO_Less:
+  case OO_Greater:
+  case OO_LessEqual:
+  case OO_GreaterEqual:
+  case OO_Minus:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Uses of one parameter in the body of its function.
+class UseAnalysis {
+public:
+  UseAnalysis(const FunctionDecl *function, const ParmVarDecl *param)
+      : function(function), param(param) {}
+
+  // Returns whether no use of the parameter can modify or move it. Also
+  // finds out whether the function calls itself.
+  bool isReadOnly() {
+    std::vector<const DeclRefExpr *> uses;
+    std::vector<const Stmt *> stack;
+    if (const auto *constructor = dyn_cast<CXXConstructorDecl>(function)) {
+      for (const CXXCtorInitializer *init : constructor->inits()) {
+        stack.push_back(init->getInit());
+      }
+    }
+    stack.push_back(function->getBody());
+    while (!stack.empty()) {
+      const Stmt *stmt = stack.back();
+      stack.pop_back();
+      if (const auto *ref = dyn_cast<DeclRefExpr>(stmt)) {
+        if (ref->getDecl() == param) {
+          uses.push_back(ref);
+        }
+      } else if (const auto *call = dyn_cast<CallExpr>(stmt)) {
+        const FunctionDecl *callee = call->getDirectCallee();
+        if (callee && callee->getCanonicalDecl() ==
+                          function->getCanonicalDecl()) {
+          recursive = true;
+        }
+      }
+      for (const Stmt *child : stmt->children()) {
+        if (child) {
+          parents[child] = stmt;
+          stack.push_back(child);
+        }
+      }
+    }
+
+    for (const DeclRefExpr *use : uses) {
+      if (!isReadOnlyUse(use)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool isRecursive() const { return recursive; }
+
+private:
+  enum class Mode {
+    // The parameter, or a part of it like an element, as an lvalue.
+    Object,
+    // An iterator or pointer into the parameter.
+    Iterator,
+  };
+
+  const FunctionDecl *function;
+  const ParmVarDecl *param;
+  llvm::DenseMap<const Stmt *, const Stmt *> parents;
+  bool recursive = false;
+
+  const Stmt *getParent(const Stmt *stmt) const {
+    return parents.lookup(stmt);
+  }
+
+  bool isReadOnlyUse(const Expr *use) const {
+    Mode mode = Mode::Object;
+    const Stmt *current = use;
+    while (const Stmt *parent = getParent(current)) {
+      if (isa<ParenExpr>(parent) || isa<MaterializeTemporaryExpr>(parent) ||
+          isa<CXXBindTemporaryExpr>(parent) || isa<ExprWithCleanups>(parent) ||
+          isa<ConditionalOperator>(parent)) {
+        current = parent;
+        continue;
+      }
+      if (const auto *cast = dyn_cast<ImplicitCastExpr>(parent)) {
+        if (cast->getCastKind() == CK_LValueToRValue) {
+          return true;
+        }
+        current = parent;
+        continue;
+      }
+      // A by-reference capture. The uses in the body are checked on their
+      // own.
+      if (isa<LambdaExpr>(parent)) {
+        return true;
+      }
+
+      if (const auto *member = dyn_cast<MemberExpr>(parent)) {
+        if (mode == Mode::Iterator && !member->isArrow()) {
+          return false;
+        }
+        const auto *method = dyn_cast<CXXMethodDecl>(member->getMemberDecl());
+        if (!method) {
+          // A field, e.g. p.first or it->second.
+          mode = Mode::Object;
+          current = parent;
+          continue;
+        }
+        const auto *call =
+            dyn_cast_or_null<CXXMemberCallExpr>(getParent(parent));
+        if (!call) {
+          return false;
+        }
+        if (method->isConst()) {
+          return true;
+        }
+        if (!method->getIdentifier()) {
+          return false;
+        }
+        if (isElementAccessor(method->getName())) {
+          mode = Mode::Object;
+        } else if (isIteratorAccessor(method->getName())) {
+          mode = Mode::Iterator;
+        } else {
+          return false;
+        }
+        current = call;
+        continue;
+      }
+
+      if (const auto *op = dyn_cast<CXXOperatorCallExpr>(parent)) {
+        OverloadedOperatorKind kind = op->getOperator();
+        bool isObject = op->getNumArgs() > 0 && op->getArg(0) == current;
+        if (mode == Mode::Iterator) {
+          if (isComparisonOrDifference(kind)) {
+            return true;
+          }
+          if (isObject && (kind == OO_Star || kind == OO_Arrow)) {
+            mode = Mode::Object;
+            current = parent;
+            continue;
+          }
+          if (kind == OO_Plus) {
+            current = parent;
+            continue;
+          }
+          return false;
+        }
+        if (kind == OO_Subscript && isObject) {
+          if (isMap(cast<Expr>(current)->getType())) {
+            return false;
+          }
+          current = parent;
+          continue;
+        }
+        return isReadOnlyArgument(op, current);
+      }
+
+      if (const auto *call = dyn_cast<CallExpr>(parent)) {
+        if (mode == Mode::Iterator) {
+          const FunctionDecl *callee = call->getDirectCallee();
+          return callee && isReadOnlyAlgorithm(callee);
+        }
+        return isReadOnlyArgument(call, current);
+      }
+
+      if (const auto *construct = dyn_cast<CXXConstructExpr>(parent)) {
+        if (mode == Mode::Iterator) {
+          // A copy of the iterator.
+          current = parent;
+          continue;
+        }
+        const CXXConstructorDecl *constructor = construct->getConstructor();
+        for (unsigned i = 0; i < construct->getNumArgs(); ++i) {
+          if (construct->getArg(i) == current) {
+            return i < constructor->getNumParams() &&
+                   isConstReferenceOrValue(
+                       constructor->getParamDecl(i)->getType());
+          }
+        }
+        return false;
+      }
+
+      if (const auto *unary = dyn_cast<UnaryOperator>(parent)) {
+        if (unary->getOpcode() == UO_Deref) {
+          mode = Mode::Object;
+          current = parent;
+          continue;
+        }
+        return mode == Mode::Object && !unary->isIncrementDecrementOp() &&
+               unary->getOpcode() != UO_AddrOf;
+      }
+
+      if (const auto *binary = dyn_cast<BinaryOperator>(parent)) {
+        if (binary->isAssignmentOp()) {
+          return binary->getRHS() == current;
+        }
+        // Pointer arithmetic on data().
+        if (mode == Mode::Iterator && binary->isAdditiveOp()) {
+          current = parent;
+          continue;
+        }
+        return true;
+      }
+
+      if (const auto *subscript = dyn_cast<ArraySubscriptExpr>(parent)) {
+        if (subscript->getBase() != current) {
+          return true;
+        }
+        mode = Mode::Object;
+        current = parent;
+        continue;
+      }
+
+      if (const auto *declStmt = dyn_cast<DeclStmt>(parent)) {
+        return mode == Mode::Object && isReadOnlyBinding(declStmt, current);
+      }
+      return false;
+    }
+    return false;
+  }
+
+  // Whether the call only reads the argument current.
+  bool isReadOnlyArgument(const CallExpr *call, const Stmt *current) const {
+    const FunctionDecl *callee = call->getDirectCallee();
+    if (!callee) {
+      return false;
+    }
+    unsigned index = 0;
+    while (index < call->getNumArgs() && call->getArg(index) != current) {
+      ++index;
+    }
+    if (index == call->getNumArgs()) {
+      return false;
+    }
+    if (isa<CXXOperatorCallExpr>(call) && isa<CXXMethodDecl>(callee)) {
+      if (index == 0) {
+        return cast<CXXMethodDecl>(callee)->isConst();
+      }
+      --index;
+    }
+    // Variadic arguments are copied.
+    return index >= callee->getNumParams() ||
+           isConstReferenceOrValue(callee->getParamDecl(index)->getType());
+  }
+
+  // Whether the variable initialized with current can't modify it. The
+  // range of a range-based for loop is bound to a reference, so the loop
+  // variable decides.
+  bool isReadOnlyBinding(const DeclStmt *declStmt, const Stmt *current) const {
+    const auto *rangeFor = dyn_cast_or_null<CXXForRangeStmt>(
+        getParent(declStmt));
+    for (const Decl *decl : declStmt->decls()) {
+      const auto *var = dyn_cast<VarDecl>(decl);
+      if (!var || var->getInit() != current) {
+        continue;
+      }
+      if (rangeFor && rangeFor->getRangeStmt() == declStmt) {
+        var = rangeFor->getLoopVariable();
+      }
+      return isConstReferenceOrValue(var->getType());
+    }
+    return false;
+  }
+};
+
+class ParamHandler : public MatchFinder::MatchCallback {
+public:
+  StringRef getID() const override { return "container_by_value"; }
+
+  void setDiagIDs(unsigned recursiveCopyID, unsigned copyID) {
+    this->recursiveCopyID = recursiveCopyID;
+    this->copyID = copyID;
+  }
+
+  void run(const MatchFinder::MatchResult &result) override {
+    const auto *param = result.Nodes.getNodeAs<ParmVarDecl>(PARAM_BINDING);
+    const auto *function = dyn_cast<FunctionDecl>(param->getDeclContext());
+    // The parameters of a prototype are checked with its definition.
+    if (!function || !function->doesThisDeclarationHaveABody() ||
+        !param->getIdentifier()) {
+      return;
+    }
+    // The signature of a virtual method is shared with its overrides.
+    if (const auto *method = dyn_cast<CXXMethodDecl>(function)) {
+      if (method->isVirtual()) {
+        return;
+      }
+    }
+
+    UseAnalysis analysis(function, param);
+    if (!analysis.isReadOnly()) {
+      return;
+    }
+    auto builder = result.Context->getDiagnostics().Report(
+        param->getLocation(),
+        analysis.isRecursive() ? recursiveCopyID : copyID);
+
+    // All declarations have to change together, or the prototypes would
+    // declare another overload.
+    std::vector<FixItHint> hints;
+    const SourceManager &sourceManager = *result.SourceManager;
+    unsigned index = param->getFunctionScopeIndex();
+    for (const FunctionDecl *redecl : function->redecls()) {
+      if (index >= redecl->getNumParams() ||
+          !addFixIts(redecl->getParamDecl(index), sourceManager,
+                     result.Context->getLangOpts(), hints)) {
+        return;
+      }
+    }
+    for (const FixItHint &hint : hints) {
+      builder.AddFixItHint(hint);
+    }
+  }
+
+private:
+  unsigned recursiveCopyID = 0;
+  unsigned copyID = 0;
+
+  // Adds the hints turning param into a const reference. Returns false if
+  // it can't be rewritten.
+  static bool addFixIts(const ParmVarDecl *param,
+                        const SourceManager &sourceManager,
+                        const LangOptions &langOptions,
+                        std::vector<FixItHint> &hints) {
+    TypeLoc typeLoc = param->getTypeSourceInfo()->getTypeLoc();
+    SourceLocation typeBegin = typeLoc.getBeginLoc();
+    SourceLocation name = param->getLocation();
+    if (!param->getIdentifier()) {
+      name = Lexer::getLocForEndOfToken(typeLoc.getEndLoc(), 0, sourceManager,
+                                        langOptions);
+    }
+    if (!typeBegin.isFileID() || !name.isValid() || !name.isFileID() ||
+        !sourceManager.isInMainFile(typeBegin)) {
+      return false;
+    }
+    if (!param->getType().isConstQualified()) {
+      hints.push_back(FixItHint::CreateInsertion(typeBegin, "const "));
+    }
+    hints.push_back(FixItHint::CreateInsertion(
+        name, param->getIdentifier() ? "&" : " &"));
+    return true;
+  }
+};
+
+class ContainerByValueChecker : public Checker {
+public:
+  StringRef getName() const override { return "container_by_value"; }
+
+  void registerDiagnostics(DiagnosticRegistry &registry) override {
+    callback.setDiagIDs(
+        registry.add(*this, DiagnosticsEngine::Error,
+                     "Pass the container by const reference. It is copied "
+                     "on every recursive call."),
+        registry.add(*this, DiagnosticsEngine::Warning,
+                     "Pass the container by const reference instead of "
+                     "copying it."));
+  }
+
+  void registerMatchers(CheckerMatchFinder &finder) override {
+    finder.addMatcher(
+      parmVarDecl(
+        isExpansionInMainFile(),
+        hasType(isCopiedContainer())
+      ).bind(PARAM_BINDING),
+      &callback
+    );
+  }
+
+private:
+  ParamHandler callback;
+};
+
+} // namespace
+
+std::unique_ptr<Checker> createContainerByValueChecker() {
+  return llvm::make_unique<ContainerByValueChecker>();
+}
+
+} // namespace complint
@@ -0,0 +1,80 @@
+//------------------------------------------------------------------------------
+// Check for commented out debug output (cout, cerr or printf) and suggests
+// using debug macro instead.
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <cctype>
+
+#include "clang/Basic/Diagnostic.h"
+#include "clang/Basic/SourceManager.h"
+
+#include "checker.h"
+
+namespace complint {
+namespace {
+
+using namespace clang;
+
+const StringRef DEBUG_OUTPUTS[] = {"cout", "cerr", "printf"};
+
+bool isIdentifierChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// Whether line uses one of DEBUG_OUTPUTS as a whole word.
+bool hasDebugOutput(StringRef line) {
+  for (StringRef output : DEBUG_OUTPUTS) {
+    for (size_t pos = line.find(output); pos != StringRef::npos;
+         pos = line.find(output, pos + 1)) {
+      size_t end = pos + output.size();
+      if ((pos == 0 || !isIdentifierChar(line[pos - 1])) &&
+          (end == line.size() || !isIdentifierChar(line[end]))) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+class DebugMacroChecker : public Checker {
+public:
+  StringRef getName() const override { return "debug_macro"; }
+
+  void registerDiagnostics(DiagnosticRegistry &registry) override {
+    DiagID = registry.add(
+      *this, DiagnosticsEngine::Error,
+      "Use debugging macro instead. #define D(x) cout << \"line \" "
+      "<< __LINE__ << \": \" << #x << \"=\" << x << endl;");
+  }
+
+  bool checksComments() const override { return true; }
+
+  void checkComment(DiagnosticsEngine &diagnostics,
+                    SourceManager &sourceManager, SourceRange range,
+                    StringRef text) override {
+    // Every commented out line is reported: the first one at the start of
+    // the comment, the others of a block comment where their text starts.
+    size_t lineStart = 0;
+    while (lineStart < text.size()) {
+      size_t lineEnd = std::min(text.find('\n', lineStart), text.size());
+      StringRef line = text.slice(lineStart, lineEnd);
+      if (hasDebugOutput(line)) {
+        size_t offset =
+            lineStart == 0 ? 0 : lineStart + line.find_first_not_of(" \t");
+        diagnostics.Report(range.getBegin().getLocWithOffset(offset), DiagID);
+      }
+      lineStart = lineEnd + 1;
+    }
+  }
+
+private:
+  unsigned DiagID = 0;
+};
+
+} // namespace
+
+std::unique_ptr<Checker> createDebugMacroChecker() {
+  return llvm::make_unique<DebugMacroChecker>();
+}
+
+} // namespace complint
@@ -0,0 +1,321 @@
+//------------------------------------------------------------------------------
+// Checks for recursive functions whose stack frames are too large for a deep
+// recursion, e.g. a dfs with a local array.
+//
+// The call graph of the functions defined in the main file is built once per
+// translation unit and its cycles are found with Tarjan's algorithm. The frame
+// of every function on a cycle is estimated from its parameters and local
+// variables; if it times the expected depth exceeds the stack limit, the
+// function is reported. Both are options of the check.
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <vector>
+
+#include "clang/AST/AST.h"
+#include "clang/Basic/Diagnostic.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
+
+#include "checker.h"
+
+namespace complint {
+namespace {
+
+using namespace clang;
+
+// The return address and the saved frame pointer.
+constexpr uint64_t FRAME_OVERHEAD = 16;
+
+// Size of a variable of type on the stack, or 0 if it isn't known.
+uint64_t getStackSize(const ASTContext &context, QualType type) {
+  if (type->isReferenceType() || type->isDependentType() ||
+      type->isIncompleteType() || type->isVariablyModifiedType()) {
+    return 0;
+  }
+  return context.getTypeSizeInChars(type).getQuantity();
+}
+
+// Functions defined in the main file and the calls between them.
+class CallGraph {
+public:
+  explicit CallGraph(ASTContext &context) : context(context) {
+    const SourceManager &sourceManager = context.getSourceManager();
+    for (const Decl *decl : context.getTranslationUnitDecl()->noload_decls()) {
+      if (sourceManager.isInMainFile(
+              sourceManager.getExpansionLoc(decl->getLocation()))) {
+        collect(decl, decl);
+      }
+    }
+    for (size_t i = 0; i < functions.size(); ++i) {
+      addCalls(i);
+    }
+    findCycles();
+  }
+
+  // Whether function can call itself.
+  bool isRecursive(const FunctionDecl *function) const {
+    auto it = indices.find(function);
+    return it != indices.end() && nodes[it->second].recursive;
+  }
+
+  // Whether the top-level declaration decl contains a function which calls
+  // other functions of the main file. Whether it is on a cycle through them
+  // depends on their bodies, also when an edit of one of them has just
+  // broken the cycle.
+  bool callsOthers(const Decl *decl) const { return callers.count(decl); }
+
+  // Estimated size of the stack frame of function.
+  uint64_t getFrameSize(const FunctionDecl *function) const;
+
+private:
+  struct Node {
+    const Decl *topLevel;
+    std::vector<unsigned> callees;
+    bool recursive = false;
+    // State of Tarjan's algorithm.
+    unsigned index = 0;
+    unsigned lowLink = 0;
+    bool visited = false;
+    bool onStack = false;
+  };
+
+  ASTContext &context;
+  std::vector<const FunctionDecl *> functions;
+  std::vector<Node> nodes;
+  llvm::DenseMap<const FunctionDecl *, unsigned> indices;
+  SmallPtrSet<const Decl *, 8> callers;
+
+  void collect(const Decl *decl, const Decl *topLevel);
+  void addCalls(unsigned caller);
+  void addCall(unsigned caller, const FunctionDecl *callee);
+  void findCycles();
+  void markComponent(const std::vector<unsigned> &component);
+};
+
+void CallGraph::collect(const Decl *decl, const Decl *topLevel) {
+  if (const auto *functionTemplate = dyn_cast<FunctionTemplateDecl>(decl)) {
+    decl = functionTemplate->getTemplatedDecl();
+  } else if (const auto *classTemplate = dyn_cast<ClassTemplateDecl>(decl)) {
+    decl = classTemplate->getTemplatedDecl();
+  }
+  if (const auto *function = dyn_cast<FunctionDecl>(decl)) {
+    if (function->doesThisDeclarationHaveABody()) {
+      indices[function] = functions.size();
+      functions.push_back(function);
+      nodes.emplace_back();
+      nodes.back().topLevel = topLevel;
+    }
+    return;
+  }
+  // Namespaces, classes and extern "C" blocks.
+  if (const auto *context = dyn_cast<DeclContext>(decl)) {
+    for (const Decl *child : context->decls()) {
+      collect(child, topLevel);
+    }
+  }
+}
+
+void CallGraph::addCalls(unsigned caller) {
+  std::vector<const Stmt *> stack = {functions[caller]->getBody()};
+  while (!stack.empty()) {
+    const Stmt *stmt = stack.back();
+    stack.pop_back();
+    if (const auto *call = dyn_cast<CallExpr>(stmt)) {
+      if (const FunctionDecl *callee = call->getDirectCallee()) {
+        addCall(caller, callee);
+      } else if (const auto *lookup = dyn_cast<UnresolvedLookupExpr>(
+                     call->getCallee()->IgnoreParenImpCasts())) {
+        // A call in a template, to any of the candidates.
+        for (const NamedDecl *candidate : lookup->decls()) {
+          if (const auto *functionTemplate =
+                  dyn_cast<FunctionTemplateDecl>(candidate)) {
+            addCall(caller, functionTemplate->getTemplatedDecl());
+          } else if (const auto *function = dyn_cast<FunctionDecl>(candidate)) {
+            addCall(caller, function);
+          }
+        }
+      }
+    }
+    for (const Stmt *child : stmt->children()) {
+      if (child) {
+        stack.push_back(child);
+      }
+    }
+  }
+}
+
+void CallGraph::addCall(unsigned caller, const FunctionDecl *callee) {
+  const FunctionDecl *definition = nullptr;
+  if (!callee->hasBody(definition)) {
+    return;
+  }
+  if (const FunctionDecl *pattern =
+          definition->getTemplateInstantiationPattern()) {
+    definition = pattern;
+  }
+  auto it = indices.find(definition);
+  if (it == indices.end()) {
+    return;
+  }
+  if (it->second == caller) {
+    nodes[caller].recursive = true;
+  } else {
+    callers.insert(nodes[caller].topLevel);
+  }
+  nodes[caller].callees.push_back(it->second);
+}
+
+void CallGraph::findCycles() {
+  // Tarjan's algorithm with an explicit stack, as long call chains would
+  // nest deeply. Each frame is a node and the next of its callees to visit.
+  unsigned nextIndex = 0;
+  std::vector<unsigned> componentStack;
+  std::vector<std::pair<unsigned, size_t>> frames;
+  for (unsigned root = 0; root < nodes.size(); ++root) {
+    if (nodes[root].visited) {
+      continue;
+    }
+    frames.emplace_back(root, 0);
+    while (!frames.empty()) {
+      unsigned node = frames.back().first;
+      size_t &next = frames.back().second;
+      Node &current = nodes[node];
+      if (next == 0 && !current.visited) {
+        current.visited = true;
+        current.index = current.lowLink = nextIndex++;
+        current.onStack = true;
+        componentStack.push_back(node);
+      }
+      if (next < current.callees.size()) {
+        unsigned callee = current.callees[next++];
+        if (!nodes[callee].visited) {
+          frames.emplace_back(callee, 0);
+        } else if (nodes[callee].onStack) {
+          current.lowLink = std::min(current.lowLink, nodes[callee].index);
+        }
+        continue;
+      }
+
+      if (current.lowLink == current.index) {
+        std::vector<unsigned> component;
+        unsigned member;
+        do {
+          member = componentStack.back();
+          componentStack.pop_back();
+          nodes[member].onStack = false;
+          component.push_back(member);
+        } while (member != node);
+        markComponent(component);
+      }
+      frames.pop_back();
+      if (!frames.empty()) {
+        Node &caller = nodes[frames.back().first];
+        caller.lowLink = std::min(caller.lowLink, current.lowLink);
+      }
+    }
+  }
+}
+
+void CallGraph::markComponent(const std::vector<unsigned> &component) {
+  if (component.size() < 2) {
+    return;
+  }
+  for (unsigned member : component) {
+    nodes[member].recursive = true;
+  }
+}
+
+uint64_t CallGraph::getFrameSize(const FunctionDecl *function) const {
+  uint64_t size = FRAME_OVERHEAD;
+  for (const ParmVarDecl *param : function->parameters()) {
+    size += getStackSize(context, param->getType());
+  }
+  std::vector<const Stmt *> stack = {function->getBody()};
+  while (!stack.empty()) {
+    const Stmt *stmt = stack.back();
+    stack.pop_back();
+    if (const auto *declStmt = dyn_cast<DeclStmt>(stmt)) {
+      for (const Decl *decl : declStmt->decls()) {
+        const auto *var = dyn_cast<VarDecl>(decl);
+        if (var && var->hasLocalStorage()) {
+          size += getStackSize(context, var->getType());
+        }
+      }
+    }
+    for (const Stmt *child : stmt->children()) {
+      // The body of a lambda runs in a frame of its own.
+      if (child && !isa<LambdaExpr>(child)) {
+        stack.push_back(child);
+      }
+    }
+  }
+  return size;
+}
+
+class DeepRecursionChecker : public Checker {
+public:
+  StringRef getName() const override { return "deep_recursion"; }
+
+  void registerDiagnostics(DiagnosticRegistry &registry) override {
+    DiagID = registry.add(
+        *this, DiagnosticsEngine::Error,
+        "Recursion may overflow the stack: about %0 bytes per call, %1 MB at "
+        "depth %2. Move the large local variables out of the function.");
+  }
+
+  bool setOption(StringRef name, StringRef value) override {
+    if (name == "depth") {
+      return !value.getAsInteger(10, depth);
+    }
+    if (name == "stack_limit_mb") {
+      return !value.getAsInteger(10, stackLimitMB);
+    }
+    return false;
+  }
+
+  bool isNonLocal(const Decl *decl) const override {
+    return getCallGraph(decl->getASTContext()).callsOthers(decl);
+  }
+
+  void visitDecl(const Decl *decl, const TraversalContext &context) override {
+    const auto *function = dyn_cast<FunctionDecl>(decl);
+    if (!function || !function->doesThisDeclarationHaveABody()) {
+      return;
+    }
+    const CallGraph &callGraph = getCallGraph(context.getASTContext());
+    if (!callGraph.isRecursive(function)) {
+      return;
+    }
+    uint64_t frameSize = callGraph.getFrameSize(function);
+    uint64_t total = frameSize * depth;
+    if (total > (stackLimitMB << 20)) {
+      context.getDiagnostics().Report(function->getLocation(), DiagID)
+          << unsigned(frameSize) << unsigned(total >> 20) << depth;
+    }
+  }
+
+private:
+  unsigned DiagID = 0;
+  unsigned depth = 100000;
+  uint64_t stackLimitMB = 8;
+  // Built at the first use in a translation unit.
+  mutable std::unique_ptr<CallGraph> callGraph;
+  mutable const ASTContext *callGraphContext = nullptr;
+
+  const CallGraph &getCallGraph(ASTContext &context) const {
+    if (!callGraph || callGraphContext != &context) {
+      callGraph = llvm::make_unique<CallGraph>(context);
+      callGraphContext = &context;
+    }
+    return *callGraph;
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Checker> createDeepRecursionChecker() {
+  return llvm::make_unique<DeepRecursionChecker>();
+}
+
+} // namespace complint
@@ -0,0 +1,334 @@
+//------------------------------------------------------------------------------
+// Checks if the commands for the fast cin/cout are in the code.
+//
+// The body of main is walked in source order, following the calls into the
+// functions of the main file, so the commands are also found in helpers like
+// init_io(). They have to run before the first input or output, cin.tie()
+// has to be given a null pointer, and once stdio is unsynced, stdio and
+// iostream mustn't be mixed.
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <vector>
+
+#include "clang/AST/AST.h"
+#include "clang/Basic/Diagnostic.h"
+
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/StringSwitch.h"
+
+#include "checker.h"
+
+namespace complint {
+namespace {
+
+using namespace clang;
+
+constexpr char FAST_IO_CODE[] = "ios_base::sync_with_stdio(false);";
+constexpr char UNTIE_CODE[] = "cin.tie(NULL);";
+
+enum class IOFamily { None, Stdio, IOStream };
+
+// std::cin, std::cout, std::cerr or std::clog.
+bool isStandardStream(const Expr *expr) {
+  const auto *ref = dyn_cast<DeclRefExpr>(expr->IgnoreParenImpCasts());
+  if (!ref) {
+    return false;
+  }
+  const auto *var = dyn_cast<VarDecl>(ref->getDecl());
+  if (!var || !var->getIdentifier() || !var->isInStdNamespace()) {
+    return false;
+  }
+  StringRef name = var->getName();
+  return name == "cin" || name == "cout" || name == "cerr" || name == "clog";
+}
+
+bool isStandardInput(const Expr *expr) {
+  return isStandardStream(expr) &&
+         cast<DeclRefExpr>(expr->IgnoreParenImpCasts())->getDecl()->getName() ==
+             "cin";
+}
+
+// A function of the C standard input/output on stdin or stdout.
+bool isStdioFunction(const FunctionDecl *function) {
+  if (!function->getIdentifier()) {
+    return false;
+  }
+  return StringSwitch<bool>(function->getName())
+      .Cases("printf", "scanf", "puts", "gets", true)
+      .Cases("putchar", "getchar", "vprintf", "vscanf", true)
+      .Default(false);
+}
+
+// The object a member function is called on, e.g. cin.tie(0) in
+// cin.tie(0)->sync_with_stdio(false), or null.
+const Expr *getObject(const CallExpr *call) {
+  const auto *member =
+      dyn_cast<MemberExpr>(call->getCallee()->IgnoreParenImpCasts());
+  return member ? member->getBase() : nullptr;
+}
+
+// Whether expr is a null pointer: NULL, nullptr, 0 or a constant null
+// pointer of some type.
+bool isNullPointer(const Expr *expr, ASTContext &context) {
+  if (expr->isNullPointerConstant(context,
+                                  Expr::NPC_ValueDependentIsNotNull) !=
+      Expr::NPCK_NotNull) {
+    return true;
+  }
+  Expr::EvalResult result;
+  return expr->EvaluateAsRValue(result, context) && result.Val.isLValue() &&
+         result.Val.getLValueBase().isNull() &&
+         result.Val.getLValueOffset().isZero();
+}
+
+// Walks main and the functions it calls in the order the statements are
+// written, the callee of a call right after its arguments. Every function is
+// walked once, at its first call.
+class IOWalker {
+public:
+  IOWalker(ASTContext &context, DiagnosticsEngine &diagnostics,
+           const FunctionDecl *main, unsigned fastIOMissingID,
+           unsigned untieMissingID, unsigned syncEnabledID,
+           unsigned tieNotNullID, unsigned mixedIOID)
+      : context(context), sourceManager(context.getSourceManager()),
+        diagnostics(diagnostics),
+        mainBody(cast<CompoundStmt>(main->getBody())),
+        fastIOMissingID(fastIOMissingID), untieMissingID(untieMissingID),
+        syncEnabledID(syncEnabledID), tieNotNullID(tieNotNullID),
+        mixedIOID(mixedIOID) {
+    walked.insert(main);
+  }
+
+  void run() {
+    // An explicit stack, as long chains of << would nest deeply.
+    std::vector<std::pair<const Stmt *, const FunctionDecl *>> stack;
+    stack.emplace_back(mainBody, nullptr);
+    while (!stack.empty()) {
+      const Stmt *stmt = stack.back().first;
+      const FunctionDecl *callee = stack.back().second;
+      stack.pop_back();
+      if (callee) {
+        stack.emplace_back(callee->getBody(), nullptr);
+        continue;
+      }
+      if (!stmt) {
+        continue;
+      }
+      const Expr *object = nullptr;
+      if (!visit(stmt, object)) {
+        if (object) {
+          stack.emplace_back(object, nullptr);
+        }
+        continue;
+      }
+
+      if (const auto *call = dyn_cast<CallExpr>(stmt)) {
+        const FunctionDecl *definition = nullptr;
+        const FunctionDecl *function = call->getDirectCallee();
+        if (function && function->hasBody(definition) &&
+            isInMainFile(definition->getLocation()) &&
+            walked.insert(definition).second) {
+          stack.emplace_back(nullptr, definition);
+        }
+      }
+      size_t end = stack.size();
+      for (const Stmt *child : stmt->children()) {
+        stack.emplace_back(child, nullptr);
+      }
+      std::reverse(stack.begin() + end, stack.end());
+    }
+  }
+
+private:
+  ASTContext &context;
+  SourceManager &sourceManager;
+  DiagnosticsEngine &diagnostics;
+  const CompoundStmt *mainBody;
+  unsigned fastIOMissingID;
+  unsigned untieMissingID;
+  unsigned syncEnabledID;
+  unsigned tieNotNullID;
+  unsigned mixedIOID;
+
+  SmallPtrSet<const FunctionDecl *, 16> walked;
+  bool unsynced = false;
+  bool untied = false;
+  bool missingReported = false;
+  bool mixingReported = false;
+  // The family of the first input or output after unsyncing.
+  IOFamily family = IOFamily::None;
+
+  bool isInMainFile(SourceLocation location) const {
+    return sourceManager.isInMainFile(sourceManager.getExpansionLoc(location));
+  }
+
+  // Handles stmt and returns whether its children should be walked. If not,
+  // object may be set to the only one of them to walk.
+  bool visit(const Stmt *stmt, const Expr *&object) {
+    if (const auto *call = dyn_cast<CallExpr>(stmt)) {
+      const FunctionDecl *function = call->getDirectCallee();
+      if (!function || !function->getIdentifier()) {
+        return true;
+      }
+      // The setup of the streams isn't input or output, but the object it is
+      // called on may be more setup, as in cin.tie(0)->sync_with_stdio(0).
+      StringRef name = function->getName();
+      if (name == "sync_with_stdio" && call->getNumArgs() == 1) {
+        visitSync(call);
+        object = getObject(call);
+        if (object && isStandardStream(object)) {
+          object = nullptr;
+        }
+        return false;
+      }
+      const auto *memberCall = dyn_cast<CXXMemberCallExpr>(call);
+      if (name == "tie" && memberCall &&
+          isStandardStream(memberCall->getImplicitObjectArgument())) {
+        // Tying cout, e.g. cout.tie(0), is harmless boilerplate.
+        if (call->getNumArgs() == 1 &&
+            isStandardInput(memberCall->getImplicitObjectArgument())) {
+          visitTie(call);
+        }
+        return false;
+      }
+      if (isStdioFunction(function) && !isInMainFile(function->getLocation())) {
+        visitIO(call->getLocStart(), IOFamily::Stdio);
+      }
+      return true;
+    }
+    if (const auto *ref = dyn_cast<DeclRefExpr>(stmt)) {
+      if (isStandardStream(ref)) {
+        visitIO(ref->getLocStart(), IOFamily::IOStream);
+      }
+    }
+    return true;
+  }
+
+  void visitSync(const CallExpr *call) {
+    const Expr *arg = call->getArg(0);
+    bool enabled;
+    if (!arg->EvaluateAsBooleanCondition(enabled, context) || enabled) {
+      SourceLocation location = arg->getLocStart();
+      if (!isInMainFile(location)) {
+        location = call->getLocStart();
+      }
+      diagnostics.Report(location, syncEnabledID);
+      return;
+    }
+    unsynced = true;
+  }
+
+  void visitTie(const CallExpr *call) {
+    if (!isNullPointer(call->getArg(0), context)) {
+      diagnostics.Report(call->getLocStart(), tieNotNullID);
+      return;
+    }
+    untied = true;
+  }
+
+  void visitIO(SourceLocation location, IOFamily used) {
+    if (!isInMainFile(location)) {
+      return;
+    }
+    if (!missingReported && (!unsynced || !untied)) {
+      missingReported = true;
+      reportMissing(location);
+    }
+    if (!unsynced || mixingReported) {
+      return;
+    }
+    if (family == IOFamily::None) {
+      family = used;
+    } else if (family != used) {
+      mixingReported = true;
+      diagnostics.Report(location, mixedIOID);
+    }
+  }
+
+  // Reports the input or output at location, which runs before fast I/O is
+  // enabled, with a fix-it inserting what is missing at the start of main.
+  void reportMissing(SourceLocation location) {
+    std::string indent = "    ";
+    if (!mainBody->body_empty()) {
+      unsigned column = sourceManager.getExpansionColumnNumber(
+          mainBody->body_front()->getLocStart());
+      indent = std::string(column > 0 ? column - 1 : 0, ' ');
+    }
+    std::string code;
+    if (!unsynced) {
+      code += "\n" + indent + FAST_IO_CODE;
+    }
+    if (!untied) {
+      code += "\n" + indent + UNTIE_CODE;
+    }
+
+    auto builder = diagnostics.Report(
+        location, unsynced ? untieMissingID : fastIOMissingID);
+    SourceLocation brace = mainBody->getLBracLoc();
+    if (brace.isFileID()) {
+      builder.AddFixItHint(
+          FixItHint::CreateInsertion(brace.getLocWithOffset(1), code));
+    }
+  }
+};
+
+class FastCinChecker : public Checker {
+public:
+  StringRef getName() const override { return "fast_cin"; }
+
+  void registerDiagnostics(DiagnosticRegistry &registry) override {
+    fastIOMissingID = registry.add(
+        *this, DiagnosticsEngine::Error,
+        "Enable fast input/output. "
+        "ios_base::sync_with_stdio(false); cin.tie(NULL);");
+    untieMissingID = registry.add(*this, DiagnosticsEngine::Error,
+                                  "Add cin.tie(NULL);");
+    syncEnabledID = registry.add(*this, DiagnosticsEngine::Error,
+                                 "Sync with stdio shuold be turned off.");
+    tieNotNullID = registry.add(*this, DiagnosticsEngine::Error,
+                                "cin should be untied with cin.tie(NULL).");
+    mixedIOID = registry.add(
+        *this, DiagnosticsEngine::Error,
+        "Don't mix stdio and iostream after sync_with_stdio(false).");
+  }
+
+  // The findings in main depend on all functions it calls.
+  bool isNonLocal(const Decl *decl) const override {
+    const auto *function = dyn_cast<FunctionDecl>(decl);
+    return function && function->isMain();
+  }
+
+  // The walk from main also reports in the functions it calls, and leaves
+  // those which main no longer calls without findings.
+  bool isProgramWide() const override { return true; }
+
+  void visitDecl(const Decl *decl, const TraversalContext &context) override {
+    const auto *function = dyn_cast<FunctionDecl>(decl);
+    if (!function || !function->isMain() ||
+        !function->doesThisDeclarationHaveABody()) {
+      return;
+    }
+    if (!isa<CompoundStmt>(function->getBody())) {
+      return;
+    }
+    IOWalker(context.getASTContext(), context.getDiagnostics(), function,
+             fastIOMissingID, untieMissingID, syncEnabledID, tieNotNullID,
+             mixedIOID)
+        .run();
+  }
+
+private:
+  unsigned fastIOMissingID = 0;
+  unsigned untieMissingID = 0;
+  unsigned syncEnabledID = 0;
+  unsigned tieNotNullID = 0;
+  unsigned mixedIOID = 0;
+};
+
+} // namespace
+
+std::unique_ptr<Checker> createFastCinChecker() {
+  return llvm::make_unique<FastCinChecker>();
+}
+
+} // namespace complint
@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------------
+// Checks for floating point comparissons, which don't use epsilon.
+//------------------------------------------------------------------------------
+#include "clang/AST/AST.h"
+#include "clang/Basic/Diagnostic.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/Lex/Lexer.h"
+
+#include "llvm/Support/raw_ostream.h"
+
+#include "checker.h"
+
+namespace complint {
+namespace {
+
+using namespace clang;
+using namespace ast_matchers;
+
+constexpr char EQUALS_OP_BINDING[] = "floatingPointComp";
+
+SmallString<128> getFloatEqualsReplecementHint(const BinaryOperator& comparison,
+                                               StringRef epsilon) {
+  SmallString<128> str;
+  llvm::raw_svector_ostream hintOS(str);
+  LangOptions langOpts;
+  langOpts.CPlusPlus = true;
+  PrintingPolicy policy(langOpts);
+  hintOS << "abs(";
+  comparison.getLHS()->printPretty(hintOS, nullptr, policy);
+  hintOS << " - (" ;
+  comparison.getRHS()->printPretty(hintOS, nullptr, policy);
+  hintOS << (comparison.getOpcode() == BO_EQ ? ")) < " : ")) >= ")
+         << epsilon;
+  return str;
+}
+
+class EqualsHandler : public MatchFinder::MatchCallback {
+public:
+  EqualsHandler() {}
+
+  // Key of the time spent in the callback when the matchers are profiled.
+  StringRef getID() const override { return "floating_point_comp"; }
+
+  void setDiagID(unsigned diagID) { ID = diagID; }
+  void setEpsilon(StringRef name) { epsilon = name; }
+
+  virtual void run(const MatchFinder::MatchResult &result) {
+    if (const BinaryOperator *comparison =
+          result.Nodes.getNodeAs<BinaryOperator>(EQUALS_OP_BINDING)) {
+      auto& diagnostics = result.Context->getDiagnostics();
+      auto builder = diagnostics.Report(comparison->getOperatorLoc(), ID);
+      auto locEnd = Lexer::getLocForEndOfToken(comparison->getLocEnd(),
+                                               0,
+                                               *result.SourceManager,
+                                               LangOptions());
+      SourceRange sourceRange(comparison->getLocStart(), locEnd);
+      auto hintStr = getFloatEqualsReplecementHint(*comparison, epsilon);
+      const auto hint = FixItHint::CreateReplacement(sourceRange, hintStr);
+      builder.AddFixItHint(hint);
+    }
+  }
+
+private:
+  unsigned ID = 0;
+  // Name of the constant the fix-it compares the difference with.
+  std::string epsilon = "EPS";
+};
+
+class FloatingPointCompChecker : public Checker {
+public:
+  StringRef getName() const override { return "floating_point_comp"; }
+
+  void registerDiagnostics(DiagnosticRegistry &registry) override {
+    equalsHandler.setDiagID(registry.add(
+      *this, DiagnosticsEngine::Error,
+      "This floating point operation can lead to errors."));
+  }
+
+  bool setOption(StringRef name, StringRef value) override {
+    if (name != "epsilon" || value.empty()) {
+      return false;
+    }
+    equalsHandler.setEpsilon(value);
+    return true;
+  }
+
+  void registerMatchers(CheckerMatchFinder &finder) override {
+    // Both sides of the comparison are converted to the same type, so only
+    // the LHS is checked. The predicate looks at the canonical type, so
+    // typedefs, qualifiers and long double are covered without printing the
+    // type.
+    finder.addMatcher(
+      binaryOperator(
+        isExpansionInMainFile(),
+        anyOf(hasOperatorName("=="), hasOperatorName("!=")),
+        hasLHS(hasType(realFloatingPointType()))
+      ).bind(EQUALS_OP_BINDING),
+      &equalsHandler
+    );
+  }
+
+private:
+  EqualsHandler equalsHandler;
+};
+
+} // namespace
+
+std::unique_ptr<Checker> createFloatingPointCompChecker() {
+  return llvm::make_unique<FloatingPointCompChecker>();
+}
+
+} // namespace complint
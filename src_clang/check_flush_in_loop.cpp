@@ -0,0 +1,269 @@
+//------------------------------------------------------------------------------
+// Checks for output flushed in a loop: endl, flush and fflush(stdout).
+//
+// Every flush is a write system call, so a loop printing a line per iteration
+// with endl is often what exceeds the time limit. main and the functions it
+// calls are walked like in fast_cin; a flush counts if it runs on every
+// iteration of a loop, also in a function called from one. Flushes of cerr
+// and clog, which are unbuffered anyway, aren't reported.
+//
+// Interactive problems have to flush after every query. A comment containing
+// "complint: interactive" anywhere in the file turns the check off; the text
+// in a string literal doesn't.
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+#include "clang/AST/AST.h"
+#include "clang/Basic/Diagnostic.h"
+
+#include "llvm/ADT/SmallPtrSet.h"
+
+#include "checker.h"
+#include "main_file_traversal.h"
+
+namespace complint {
+namespace {
+
+using namespace clang;
+
+constexpr char INTERACTIVE_MARKER[] = "complint: interactive";
+
+// std::endl or std::flush passed to operator<<.
+const FunctionDecl *getManipulator(const Expr *expr) {
+  const auto *ref = dyn_cast<DeclRefExpr>(expr->IgnoreParenImpCasts());
+  if (!ref) {
+    return nullptr;
+  }
+  const auto *function = dyn_cast<FunctionDecl>(ref->getDecl());
+  if (!function || !function->getIdentifier() ||
+      !function->isInStdNamespace()) {
+    return nullptr;
+  }
+  StringRef name = function->getName();
+  return name == "endl" || name == "flush" ? function : nullptr;
+}
+
+// The stream at the start of a chain like cout << a << b.
+const Expr *getStream(const Expr *expr) {
+  expr = expr->IgnoreParenImpCasts();
+  while (const auto *call = dyn_cast<CXXOperatorCallExpr>(expr)) {
+    if (call->getOperator() != OO_LessLess || call->getNumArgs() != 2) {
+      break;
+    }
+    expr = call->getArg(0)->IgnoreParenImpCasts();
+  }
+  return expr;
+}
+
+// std::cerr or std::clog, which flush on every output anyway.
+bool isUnbufferedStream(const Expr *expr) {
+  const auto *ref = dyn_cast<DeclRefExpr>(getStream(expr));
+  if (!ref) {
+    return false;
+  }
+  const auto *var = dyn_cast<VarDecl>(ref->getDecl());
+  return var && var->getIdentifier() && var->isInStdNamespace() &&
+         (var->getName() == "cerr" || var->getName() == "clog");
+}
+
+// fflush(stdout).
+bool isStdoutFlush(const CallExpr *call) {
+  const FunctionDecl *function = call->getDirectCallee();
+  if (!function || !function->getIdentifier() ||
+      function->getName() != "fflush" || call->getNumArgs() != 1) {
+    return false;
+  }
+  const auto *ref =
+      dyn_cast<DeclRefExpr>(call->getArg(0)->IgnoreParenImpCasts());
+  return ref && ref->getDecl()->getIdentifier() &&
+         ref->getDecl()->getName() == "stdout";
+}
+
+// Walks main and the functions it calls, knowing whether each statement runs
+// in a loop. A function is walked once outside of loops and once inside, at
+// its first call of each kind, unless it was already walked inside.
+class FlushWalker {
+public:
+  FlushWalker(SourceManager &sourceManager, DiagnosticsEngine &diagnostics,
+              unsigned endlID, unsigned flushID)
+      : sourceManager(sourceManager), diagnostics(diagnostics),
+        endlID(endlID), flushID(flushID) {}
+
+  void run(const FunctionDecl *main) {
+    walkedOutside.insert(main);
+    // An explicit stack, as long chains of << would nest deeply.
+    std::vector<std::tuple<const Stmt *, bool>> stack;
+    stack.emplace_back(main->getBody(), false);
+    while (!stack.empty()) {
+      const Stmt *stmt;
+      bool inLoop;
+      std::tie(stmt, inLoop) = stack.back();
+      stack.pop_back();
+      if (!stmt) {
+        continue;
+      }
+      if (inLoop) {
+        visit(stmt);
+      }
+
+      if (const auto *call = dyn_cast<CallExpr>(stmt)) {
+        const FunctionDecl *definition = nullptr;
+        const FunctionDecl *function = call->getDirectCallee();
+        if (function && function->hasBody(definition) &&
+            isInMainFile(definition->getLocation()) &&
+            markWalked(definition, inLoop)) {
+          stack.emplace_back(definition->getBody(), inLoop);
+        }
+      }
+      size_t end = stack.size();
+      for (const Stmt *child : stmt->children()) {
+        stack.emplace_back(child, inLoop || isRepeatedChild(stmt, child));
+      }
+      std::reverse(stack.begin() + end, stack.end());
+    }
+  }
+
+private:
+  SourceManager &sourceManager;
+  DiagnosticsEngine &diagnostics;
+  unsigned endlID;
+  unsigned flushID;
+
+  SmallPtrSet<const FunctionDecl *, 16> walkedOutside;
+  SmallPtrSet<const FunctionDecl *, 16> walkedInLoop;
+  SmallPtrSet<const Stmt *, 16> reported;
+
+  bool isInMainFile(SourceLocation location) const {
+    return sourceManager.isInMainFile(sourceManager.getExpansionLoc(location));
+  }
+
+  // Returns whether function still has to be walked.
+  bool markWalked(const FunctionDecl *function, bool inLoop) {
+    if (inLoop) {
+      return walkedInLoop.insert(function).second;
+    }
+    return !walkedInLoop.count(function) &&
+           walkedOutside.insert(function).second;
+  }
+
+  // Reports stmt, which runs in a loop, if it flushes.
+  void visit(const Stmt *stmt) {
+    if (const auto *call = dyn_cast<CXXOperatorCallExpr>(stmt)) {
+      if (call->getOperator() != OO_LessLess || call->getNumArgs() != 2) {
+        return;
+      }
+      const FunctionDecl *manipulator = getManipulator(call->getArg(1));
+      if (manipulator && !isUnbufferedStream(call->getArg(0))) {
+        reportManipulator(call->getArg(1), manipulator->getName() == "endl");
+      }
+      return;
+    }
+    if (const auto *memberCall = dyn_cast<CXXMemberCallExpr>(stmt)) {
+      const CXXMethodDecl *method = memberCall->getMethodDecl();
+      if (method && method->getIdentifier() && method->getName() == "flush" &&
+          method->isInStdNamespace() &&
+          !isUnbufferedStream(memberCall->getImplicitObjectArgument())) {
+        report(stmt, flushID);
+      }
+      return;
+    }
+    if (const auto *call = dyn_cast<CallExpr>(stmt)) {
+      if (isStdoutFlush(call)) {
+        report(stmt, flushID);
+      }
+    }
+  }
+
+  void report(const Stmt *stmt, unsigned diagID) {
+    if (reported.insert(stmt).second) {
+      diagnostics.Report(stmt->getLocStart(), diagID);
+    }
+  }
+
+  // Reports the endl or flush passed to operator<<. endl is replaced with a
+  // newline which doesn't flush.
+  void reportManipulator(const Expr *arg, bool isEndl) {
+    const Expr *ref = arg->IgnoreParenImpCasts();
+    if (!reported.insert(ref).second) {
+      return;
+    }
+    auto builder = diagnostics.Report(ref->getLocStart(),
+                                      isEndl ? endlID : flushID);
+    SourceRange range = ref->getSourceRange();
+    if (isEndl && range.getBegin().isFileID() && range.getEnd().isFileID()) {
+      builder.AddFixItHint(FixItHint::CreateReplacement(
+          CharSourceRange::getTokenRange(range), "'\\n'"));
+    }
+  }
+};
+
+class FlushInLoopChecker : public Checker {
+public:
+  StringRef getName() const override { return "flush_in_loop"; }
+
+  void registerDiagnostics(DiagnosticRegistry &registry) override {
+    endlID = registry.add(*this, DiagnosticsEngine::Error,
+                          "Don't flush the output in a loop. "
+                          "Use '\\n' instead of endl.");
+    flushID = registry.add(*this, DiagnosticsEngine::Error,
+                           "Don't flush the output in a loop. Add "
+                           "// complint: interactive for interactive "
+                           "problems.");
+  }
+
+  // The findings in main depend on all functions it calls.
+  bool isNonLocal(const Decl *decl) const override {
+    const auto *function = dyn_cast<FunctionDecl>(decl);
+    return function && function->isMain();
+  }
+
+  // The walk from main reports in the functions it calls.
+  bool isProgramWide() const override { return true; }
+
+  bool isGlobalEdit(StringRef oldSource, StringRef newSource) const override {
+    return isInteractive(oldSource) != isInteractive(newSource);
+  }
+
+  void visitDecl(const Decl *decl, const TraversalContext &context) override {
+    const auto *function = dyn_cast<FunctionDecl>(decl);
+    if (!function || !function->isMain() ||
+        !function->doesThisDeclarationHaveABody()) {
+      return;
+    }
+    SourceManager &sourceManager = context.getASTContext().getSourceManager();
+    if (isInteractive(
+            sourceManager.getBufferData(sourceManager.getMainFileID()))) {
+      return;
+    }
+    FlushWalker(sourceManager, context.getDiagnostics(), endlID, flushID)
+        .run(function);
+  }
+
+private:
+  unsigned endlID = 0;
+  unsigned flushID = 0;
+
+  // Whether a comment of source has the marker. Most files don't have it
+  // anywhere, so they aren't scanned.
+  static bool isInteractive(StringRef source) {
+    if (source.find(INTERACTIVE_MARKER) == StringRef::npos) {
+      return false;
+    }
+    SourceScan scan(source);
+    return std::any_of(scan.getComments().begin(), scan.getComments().end(),
+                       [&](const CommentSpan &comment) {
+                         return scan.getText(comment).find(
+                                    INTERACTIVE_MARKER) != StringRef::npos;
+                       });
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Checker> createFlushInLoopChecker() {
+  return llvm::make_unique<FlushInLoopChecker>();
+}
+
+} // namespace complint
@@ -0,0 +1,44 @@
+//------------------------------------------------------------------------------
+// Checks that no goto statements are used.
+//------------------------------------------------------------------------------
+#include "clang/AST/AST.h"
+#include "clang/Basic/Diagnostic.h"
+
+#include "checker.h"
+
+namespace complint {
+namespace {
+
+using namespace clang;
+
+class GotoChecker : public Checker {
+public:
+  StringRef getName() const override { return "goto"; }
+
+  void registerDiagnostics(DiagnosticRegistry &registry) override {
+    IDGoto = registry.add(*this, DiagnosticsEngine::Error,
+                          "Don't use goto statements.");
+    IDHell = registry.add(*this, DiagnosticsEngine::Error,
+                          "You too. And don't use goto statements.");
+  }
+
+  void visitStmt(const Stmt *stmt, const TraversalContext &context) override {
+    if (const GotoStmt *gotoStmt = dyn_cast<GotoStmt>(stmt)) {
+      StringRef labelName = gotoStmt->getLabel()->getName();
+      unsigned diagnosticsID = labelName == "hell" ? IDHell : IDGoto;
+      context.getDiagnostics().Report(gotoStmt->getLocStart(), diagnosticsID);
+    }
+  }
+
+private:
+  unsigned IDGoto = 0;
+  unsigned IDHell = 0;
+};
+
+} // namespace
+
+std::unique_ptr<Checker> createGotoChecker() {
+  return llvm::make_unique<GotoChecker>();
+}
+
+} // namespace complint
@@ -0,0 +1,427 @@
+//------------------------------------------------------------------------------
+// Estimates how many values main reads with cin or scanf and recommends a
+// buffered reader when even unsynced streams would be too slow, around a
+// million values and more.
+//
+// main and the functions it calls are walked like in fast_cin. Every read is
+// weighted by the iterations of the loops around it: the constant of a bound
+// like i < 1000000, or the input_bound option when the bound is a variable
+// read from the input, like n in i < n or t in while (t--). With the
+// insert_reader option, the report carries a fix-it inserting a reader based
+// on fread before main.
+//
+// Once such a reader is used, the rest of the input may already be in its
+// buffer, so reading with cin or scanf afterwards is reported as well.
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+#include "clang/AST/AST.h"
+#include "clang/Basic/Diagnostic.h"
+
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/StringSwitch.h"
+
+#include "checker.h"
+#include "main_file_traversal.h"
+
+namespace complint {
+namespace {
+
+using namespace clang;
+
+constexpr char READER_CODE[] =
+    R"(// Buffered reader of whitespace separated integers.
+static unsigned char inputBuffer[1 << 16];
+static size_t inputSize = 0, inputPos = 0;
+
+static inline int readChar() {
+  if (inputPos == inputSize) {
+    inputSize = fread(inputBuffer, 1, sizeof(inputBuffer), stdin);
+    inputPos = 0;
+    if (inputSize == 0) {
+      return -1;
+    }
+  }
+  return inputBuffer[inputPos++];
+}
+
+template <typename T> static inline bool readInt(T &value) {
+  int c = readChar();
+  while (c != '-' && (c < '0' || c > '9')) {
+    if (c == -1) {
+      return false;
+    }
+    c = readChar();
+  }
+  bool negative = c == '-';
+  if (negative) {
+    c = readChar();
+  }
+  value = 0;
+  for (; c >= '0' && c <= '9'; c = readChar()) {
+    value = value * 10 + (c - '0');
+  }
+  if (negative) {
+    value = -value;
+  }
+  return true;
+}
+
+)";
+
+bool isStandardInput(const Expr *expr) {
+  const auto *ref = dyn_cast<DeclRefExpr>(expr->IgnoreParenImpCasts());
+  if (!ref) {
+    return false;
+  }
+  const auto *var = dyn_cast<VarDecl>(ref->getDecl());
+  return var && var->getIdentifier() && var->isInStdNamespace() &&
+         var->getName() == "cin";
+}
+
+// The stream at the start of a chain like cin >> a >> b.
+const Expr *getStream(const Expr *expr) {
+  expr = expr->IgnoreParenImpCasts();
+  while (const auto *call = dyn_cast<CXXOperatorCallExpr>(expr)) {
+    if (call->getOperator() != OO_GreaterGreater || call->getNumArgs() != 2) {
+      break;
+    }
+    expr = call->getArg(0)->IgnoreParenImpCasts();
+  }
+  return expr;
+}
+
+const VarDecl *getVariable(const Expr *expr) {
+  const auto *ref = dyn_cast<DeclRefExpr>(expr->IgnoreParenImpCasts());
+  return ref ? dyn_cast<VarDecl>(ref->getDecl()) : nullptr;
+}
+
+bool isCalled(const CallExpr *call, StringRef name) {
+  const FunctionDecl *function = call->getDirectCallee();
+  return function && function->getIdentifier() && function->getName() == name;
+}
+
+// Number of conversions of a scanf format, e.g. 2 for "%d %lld".
+unsigned countConversions(const Expr *format) {
+  const auto *literal = dyn_cast<StringLiteral>(format->IgnoreParenImpCasts());
+  if (!literal || literal->getCharByteWidth() != 1) {
+    return 1;
+  }
+  StringRef text = literal->getString();
+  unsigned count = 0;
+  for (size_t i = 0; i + 1 < text.size(); ++i) {
+    if (text[i] == '%') {
+      if (text[i + 1] != '%') {
+        ++count;
+      }
+      ++i;
+    }
+  }
+  return count;
+}
+
+// Whether function fills a buffer of its own from the input.
+bool isBufferedReader(const FunctionDecl *function) {
+  std::vector<const Stmt *> stack = {function->getBody()};
+  while (!stack.empty()) {
+    const Stmt *stmt = stack.back();
+    stack.pop_back();
+    if (const auto *call = dyn_cast<CallExpr>(stmt)) {
+      const FunctionDecl *callee = call->getDirectCallee();
+      if (callee && callee->getIdentifier() &&
+          StringSwitch<bool>(callee->getName())
+              .Cases("fread", "fread_unlocked", "read", true)
+              .Default(false)) {
+        return true;
+      }
+    }
+    for (const Stmt *child : stmt->children()) {
+      if (child) {
+        stack.push_back(child);
+      }
+    }
+  }
+  return false;
+}
+
+// Walks main and the functions it calls in the order the statements are
+// written, knowing how often each of them runs.
+class InputWalker {
+public:
+  InputWalker(ASTContext &context, double inputBound)
+      : context(context), sourceManager(context.getSourceManager()),
+        inputBound(inputBound) {}
+
+  void run(const FunctionDecl *main) {
+    walked.insert(main);
+    // An explicit stack, as long chains of >> would nest deeply. Each entry
+    // is a statement and how many times it runs.
+    std::vector<std::tuple<const Stmt *, double>> stack;
+    stack.emplace_back(main->getBody(), 1);
+    while (!stack.empty()) {
+      const Stmt *stmt;
+      double count;
+      std::tie(stmt, count) = stack.back();
+      stack.pop_back();
+      if (!stmt) {
+        continue;
+      }
+      visit(stmt, count);
+
+      // Loops are estimated when they are reached, after the statements
+      // before them have read their bounds.
+      double iterations = 1;
+      if (isa<ForStmt>(stmt) || isa<WhileStmt>(stmt) || isa<DoStmt>(stmt) ||
+          isa<CXXForRangeStmt>(stmt)) {
+        iterations = estimateIterations(stmt);
+      }
+      size_t end = stack.size();
+      if (const auto *call = dyn_cast<CallExpr>(stmt)) {
+        const FunctionDecl *definition = nullptr;
+        const FunctionDecl *function = call->getDirectCallee();
+        if (function && function->hasBody(definition) &&
+            isInMainFile(definition->getLocation()) &&
+            walked.insert(definition).second) {
+          stack.emplace_back(definition->getBody(), count);
+        }
+      }
+      for (const Stmt *child : stmt->children()) {
+        stack.emplace_back(
+            child, isRepeatedChild(stmt, child) ? count * iterations : count);
+      }
+      std::reverse(stack.begin() + end, stack.end());
+    }
+  }
+
+  double getTotalReads() const { return totalReads; }
+  // The read which runs most often.
+  SourceLocation getHeaviestRead() const { return heaviestRead; }
+  StringRef getHeaviestReadName() const { return heaviestReadName; }
+  bool usesBufferedReader() const { return readerUsed; }
+  // Reads with cin or scanf after a buffered reader was used.
+  const std::vector<std::pair<SourceLocation, StringRef>> &
+  getReadsAfterReader() const {
+    return readsAfterReader;
+  }
+
+private:
+  ASTContext &context;
+  SourceManager &sourceManager;
+  double inputBound;
+
+  SmallPtrSet<const FunctionDecl *, 16> walked;
+  SmallPtrSet<const VarDecl *, 16> inputVariables;
+  double totalReads = 0;
+  double heaviestCount = 0;
+  SourceLocation heaviestRead;
+  StringRef heaviestReadName;
+  bool readerUsed = false;
+  std::vector<std::pair<SourceLocation, StringRef>> readsAfterReader;
+
+  bool isInMainFile(SourceLocation location) const {
+    return sourceManager.isInMainFile(sourceManager.getExpansionLoc(location));
+  }
+
+  void visit(const Stmt *stmt, double count) {
+    const auto *call = dyn_cast<CallExpr>(stmt);
+    if (!call) {
+      return;
+    }
+    if (const auto *op = dyn_cast<CXXOperatorCallExpr>(call)) {
+      if (op->getOperator() == OO_GreaterGreater && op->getNumArgs() == 2 &&
+          isStandardInput(getStream(op->getArg(0)))) {
+        addInputVariable(op->getArg(1));
+        addRead(op->getOperatorLoc(), "cin", count, 1);
+      }
+      return;
+    }
+    if (isCalled(call, "scanf") && call->getNumArgs() > 0) {
+      for (unsigned i = 1; i < call->getNumArgs(); ++i) {
+        const auto *address =
+            dyn_cast<UnaryOperator>(call->getArg(i)->IgnoreParenImpCasts());
+        if (address && address->getOpcode() == UO_AddrOf) {
+          addInputVariable(address->getSubExpr());
+        }
+      }
+      addRead(call->getLocStart(), "scanf", count,
+              countConversions(call->getArg(0)));
+      return;
+    }
+    if (isCalled(call, "getline") && call->getNumArgs() > 0 &&
+        isStandardInput(call->getArg(0))) {
+      addRead(call->getLocStart(), "getline", count, 1);
+      return;
+    }
+    const FunctionDecl *function = call->getDirectCallee();
+    const FunctionDecl *definition = nullptr;
+    if (function && function->hasBody(definition) &&
+        isInMainFile(definition->getLocation()) &&
+        isBufferedReader(definition)) {
+      readerUsed = true;
+    }
+  }
+
+  void addInputVariable(const Expr *expr) {
+    if (const VarDecl *var = getVariable(expr)) {
+      inputVariables.insert(var);
+    }
+  }
+
+  void addRead(SourceLocation location, StringRef name, double count,
+               unsigned values) {
+    if (readerUsed) {
+      readsAfterReader.emplace_back(location, name);
+      return;
+    }
+    totalReads += count * values;
+    if (count > heaviestCount) {
+      heaviestCount = count;
+      heaviestRead = location;
+      heaviestReadName = name;
+    }
+  }
+
+  // How many times the loop runs: the constant of its bound, input_bound if
+  // it depends on the input, or once if that isn't known.
+  double estimateIterations(const Stmt *loop) const {
+    const Expr *condition = nullptr;
+    if (const auto *forStmt = dyn_cast<ForStmt>(loop)) {
+      condition = forStmt->getCond();
+    } else if (const auto *whileStmt = dyn_cast<WhileStmt>(loop)) {
+      condition = whileStmt->getCond();
+    } else if (const auto *doStmt = dyn_cast<DoStmt>(loop)) {
+      condition = doStmt->getCond();
+    } else {
+      // A range-based for loop goes over a container, which is usually
+      // filled from the input.
+      return inputBound;
+    }
+    if (!condition) {
+      return 1;
+    }
+
+    if (const auto *comparison =
+            dyn_cast<BinaryOperator>(condition->IgnoreParenImpCasts())) {
+      if (comparison->isRelationalOp()) {
+        llvm::APSInt bound;
+        for (const Expr *side : {comparison->getLHS(), comparison->getRHS()}) {
+          if (side->EvaluateAsInt(bound, context) && bound > 0) {
+            return bound.getLimitedValue();
+          }
+        }
+      }
+    }
+    return dependsOnInput(condition) ? inputBound : 1;
+  }
+
+  // Whether expr uses a variable read from the input or reads itself, as
+  // in while (cin >> x).
+  bool dependsOnInput(const Expr *expr) const {
+    std::vector<const Stmt *> stack = {expr};
+    while (!stack.empty()) {
+      const Stmt *stmt = stack.back();
+      stack.pop_back();
+      if (const auto *ref = dyn_cast<DeclRefExpr>(stmt)) {
+        const auto *var = dyn_cast<VarDecl>(ref->getDecl());
+        if (var && (inputVariables.count(var) || isStandardInput(ref))) {
+          return true;
+        }
+      } else if (const auto *call = dyn_cast<CallExpr>(stmt)) {
+        if (isCalled(call, "scanf")) {
+          return true;
+        }
+      }
+      for (const Stmt *child : stmt->children()) {
+        if (child) {
+          stack.push_back(child);
+        }
+      }
+    }
+    return false;
+  }
+};
+
+class InputVolumeChecker : public Checker {
+public:
+  StringRef getName() const override { return "input_volume"; }
+
+  void registerDiagnostics(DiagnosticRegistry &registry) override {
+    volumeID = registry.add(
+        *this, DiagnosticsEngine::Warning,
+        "About 10^%0 values may be read with %1, which is too slow even "
+        "with fast I/O enabled. Read the input with a buffered reader based "
+        "on fread.");
+    mixedID = registry.add(
+        *this, DiagnosticsEngine::Error,
+        "The buffered reader may already hold this input. Don't read with "
+        "%0 after using it.");
+  }
+
+  bool setOption(StringRef name, StringRef value) override {
+    if (name == "input_bound") {
+      return !value.getAsInteger(10, inputBound);
+    }
+    if (name == "max_stream_reads") {
+      return !value.getAsInteger(10, maxStreamReads);
+    }
+    if (name == "insert_reader") {
+      insertReader = value == "true";
+      return insertReader || value == "false";
+    }
+    return false;
+  }
+
+  // The findings in main depend on all functions it calls.
+  bool isNonLocal(const Decl *decl) const override {
+    const auto *function = dyn_cast<FunctionDecl>(decl);
+    return function && function->isMain();
+  }
+
+  // The reads the walk from main reports can be in the functions it calls.
+  bool isProgramWide() const override { return true; }
+
+  void visitDecl(const Decl *decl, const TraversalContext &context) override {
+    const auto *function = dyn_cast<FunctionDecl>(decl);
+    if (!function || !function->isMain() ||
+        !function->doesThisDeclarationHaveABody()) {
+      return;
+    }
+    InputWalker walker(context.getASTContext(), inputBound);
+    walker.run(function);
+
+    DiagnosticsEngine &diagnostics = context.getDiagnostics();
+    for (const auto &read : walker.getReadsAfterReader()) {
+      diagnostics.Report(read.first, mixedID) << read.second;
+    }
+    if (walker.usesBufferedReader() ||
+        walker.getTotalReads() < double(maxStreamReads)) {
+      return;
+    }
+    auto builder =
+        diagnostics.Report(walker.getHeaviestRead(), volumeID)
+        << unsigned(std::log10(walker.getTotalReads()))
+        << walker.getHeaviestReadName();
+    SourceLocation mainBegin = function->getLocStart();
+    if (insertReader && mainBegin.isFileID()) {
+      builder.AddFixItHint(FixItHint::CreateInsertion(mainBegin, READER_CODE));
+    }
+  }
+
+private:
+  unsigned volumeID = 0;
+  unsigned mixedID = 0;
+  uint64_t inputBound = 100000;
+  uint64_t maxStreamReads = 1000000;
+  bool insertReader = false;
+};
+
+} // namespace
+
+std::unique_ptr<Checker> createInputVolumeChecker() {
+  return llvm::make_unique<InputVolumeChecker>();
+}
+
+} // namespace complint
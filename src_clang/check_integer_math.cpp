@@ -0,0 +1,175 @@
+//------------------------------------------------------------------------------
+// Checks for pow, sqrt and log2 of integers whose result is converted back to
+// an integer. The computation goes through double, which is slower than the
+// integer one and can round down, e.g. (int)pow(10, 2) may be 99.
+//
+// Where there is an exact integer replacement it is offered as a fix-it:
+// 1LL << k for pow(2, k), a * a for pow(a, 2) and __builtin_clz for log2.
+//------------------------------------------------------------------------------
+#include "clang/AST/AST.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/ASTMatchers/ASTMatchers.h"
+#include "clang/Basic/Diagnostic.h"
+#include "clang/Lex/Lexer.h"
+
+#include "llvm/ADT/StringSwitch.h"
+
+#include "checker.h"
+
+namespace complint {
+namespace {
+
+using namespace clang;
+using namespace ast_matchers;
+
+constexpr char CALL_BINDING[] = "call";
+
+// pow, sqrt or log2 of the C library or of std.
+AST_MATCHER(FunctionDecl, isIntegerUnsafeMath) {
+  if (!Node.getIdentifier() ||
+      !(Node.isInStdNamespace() ||
+        Node.getDeclContext()->getRedeclContext()->isTranslationUnit())) {
+    return false;
+  }
+  return StringSwitch<bool>(Node.getName())
+      .Cases("pow", "sqrt", "log2", true)
+      .Default(false);
+}
+
+// Arguments which are integers before they are converted to double.
+AST_MATCHER(CallExpr, hasOnlyIntegerArgs) {
+  for (const Expr *arg : Node.arguments()) {
+    if (!arg->IgnoreParenImpCasts()->getType()->isIntegerType()) {
+      return false;
+    }
+  }
+  return Node.getNumArgs() > 0;
+}
+
+AST_MATCHER(CastExpr, truncatesToInteger) {
+  return Node.getCastKind() == CK_FloatingToIntegral;
+}
+
+// Whether expr can be repeated in a replacement without evaluating anything
+// twice or needing parentheses.
+bool isSimple(const Expr *expr) {
+  expr = expr->IgnoreParenImpCasts();
+  return isa<DeclRefExpr>(expr) || isa<IntegerLiteral>(expr);
+}
+
+class CallHandler : public MatchFinder::MatchCallback {
+public:
+  StringRef getID() const override { return "integer_math"; }
+
+  void setDiagIDs(unsigned powID, unsigned sqrtID, unsigned log2ID) {
+    this->powID = powID;
+    this->sqrtID = sqrtID;
+    this->log2ID = log2ID;
+  }
+
+  void run(const MatchFinder::MatchResult &result) override {
+    const auto *call = result.Nodes.getNodeAs<CallExpr>(CALL_BINDING);
+    StringRef name = call->getDirectCallee()->getName();
+    unsigned diagID = name == "pow" ? powID : name == "sqrt" ? sqrtID : log2ID;
+    auto builder =
+        result.Context->getDiagnostics().Report(call->getLocStart(), diagID);
+
+    SourceRange range = call->getSourceRange();
+    if (!range.getBegin().isFileID() || !range.getEnd().isFileID()) {
+      return;
+    }
+    std::string replacement;
+    if (name == "pow" && call->getNumArgs() == 2) {
+      replacement = getPowReplacement(call->getArg(0), call->getArg(1),
+                                      *result.Context);
+    } else if (name == "log2" && call->getNumArgs() == 1) {
+      const Expr *arg = call->getArg(0)->IgnoreParenImpCasts();
+      bool isWide = result.Context->getTypeSize(arg->getType()) > 32;
+      replacement = isWide ? "(63 - __builtin_clzll(" : "(31 - __builtin_clz(";
+      replacement += getText(arg, *result.Context) + "))";
+    }
+    if (!replacement.empty()) {
+      builder.AddFixItHint(FixItHint::CreateReplacement(
+          CharSourceRange::getTokenRange(range), replacement));
+    }
+  }
+
+private:
+  unsigned powID = 0;
+  unsigned sqrtID = 0;
+  unsigned log2ID = 0;
+
+  static std::string getText(const Expr *expr, const ASTContext &context) {
+    return Lexer::getSourceText(
+               CharSourceRange::getTokenRange(expr->getSourceRange()),
+               context.getSourceManager(), context.getLangOpts())
+        .str();
+  }
+
+  // The exact integer form of pow(base, exponent), if there is a simple one.
+  static std::string getPowReplacement(const Expr *base, const Expr *exponent,
+                                       const ASTContext &context) {
+    llvm::APSInt value;
+    if (base->EvaluateAsInt(value, context) && value == 2) {
+      std::string shift = getText(exponent, context);
+      if (!isSimple(exponent)) {
+        shift = "(" + shift + ")";
+      }
+      return "(1LL << " + shift + ")";
+    }
+    if (exponent->EvaluateAsInt(value, context) && value == 2 &&
+        isSimple(base)) {
+      std::string factor = getText(base, context);
+      return "(1LL * " + factor + " * " + factor + ")";
+    }
+    return "";
+  }
+};
+
+class IntegerMathChecker : public Checker {
+public:
+  StringRef getName() const override { return "integer_math"; }
+
+  void registerDiagnostics(DiagnosticRegistry &registry) override {
+    callback.setDiagIDs(
+        registry.add(*this, DiagnosticsEngine::Error,
+                     "pow of integers goes through double, which is slow "
+                     "and can round down. Use binary exponentiation, or "
+                     "1LL << k for powers of two."),
+        registry.add(*this, DiagnosticsEngine::Error,
+                     "sqrt of an integer can be off by one once truncated. "
+                     "Correct the result with integer arithmetic."),
+        registry.add(*this, DiagnosticsEngine::Error,
+                     "log2 of an integer can round down. Use "
+                     "31 - __builtin_clz(x) or 63 - __builtin_clzll(x)."));
+  }
+
+  void registerMatchers(CheckerMatchFinder &finder) override {
+    // The result has to be truncated, e.g. by int k = log2(n) or
+    // (int)sqrt(n), for the floating point computation to be a mistake.
+    finder.addMatcher(
+      castExpr(
+        isExpansionInMainFile(),
+        truncatesToInteger(),
+        hasSourceExpression(ignoringParenImpCasts(
+          callExpr(
+            callee(functionDecl(isIntegerUnsafeMath())),
+            hasOnlyIntegerArgs()
+          ).bind(CALL_BINDING)
+        ))
+      ),
+      &callback
+    );
+  }
+
+private:
+  CallHandler callback;
+};
+
+} // namespace
+
+std::unique_ptr<Checker> createIntegerMathChecker() {
+  return llvm::make_unique<IntegerMathChecker>();
+}
+
+} // namespace complint
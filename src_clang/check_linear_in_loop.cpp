@@ -0,0 +1,255 @@
+//------------------------------------------------------------------------------
+// Checks for operations of linear cost inside loops, which make the loop nest
+// one power of n slower than it looks:
+//
+//   v.erase(v.begin())         - moves every element, use a deque
+//   v.insert(v.begin(), x)     - likewise, or reserve, push back and reverse
+//   find(v.begin(), v.end(), x), count(...)
+//                              - linear searches, use a set or a map
+//   s = s + c                  - copies the string, use += and reserve
+//
+// The depth of the loop nest comes from the traversal, so it is reported
+// with the complexity it implies.
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <vector>
+
+#include "clang/AST/AST.h"
+#include "clang/Basic/Diagnostic.h"
+
+#include "llvm/ADT/StringSwitch.h"
+
+#include "checker.h"
+
+namespace complint {
+namespace {
+
+using namespace clang;
+
+// Strips the temporaries and copies around an iterator or string value, and
+// its parentheses unless keepParens is set.
+const Expr *ignoreTemporaries(const Expr *expr, bool keepParens = false) {
+  while (true) {
+    expr = keepParens ? expr->IgnoreImpCasts() : expr->IgnoreParenImpCasts();
+    if (const auto *materialize = dyn_cast<MaterializeTemporaryExpr>(expr)) {
+      expr = materialize->GetTemporaryExpr();
+    } else if (const auto *bind = dyn_cast<CXXBindTemporaryExpr>(expr)) {
+      expr = bind->getSubExpr();
+    } else if (const auto *cleanups = dyn_cast<ExprWithCleanups>(expr)) {
+      expr = cleanups->getSubExpr();
+    } else if (const auto *construct = dyn_cast<CXXConstructExpr>(expr)) {
+      if (construct->getNumArgs() != 1 || isa<CXXTemporaryObjectExpr>(expr)) {
+        return expr;
+      }
+      expr = construct->getArg(0);
+    } else {
+      return expr;
+    }
+  }
+}
+
+// Name of the standard class of type, e.g. "vector", or an empty string.
+StringRef getStdClassName(QualType type) {
+  const CXXRecordDecl *record =
+      type.getNonReferenceType().getCanonicalType()->getAsCXXRecordDecl();
+  if (!record || !record->getIdentifier() || !record->isInStdNamespace()) {
+    return StringRef();
+  }
+  return record->getName();
+}
+
+// Whether expr is c.begin() or c.begin() + k for a vector or a string c,
+// a position whose elements have to be moved.
+bool isFrontIterator(const Expr *expr) {
+  expr = ignoreTemporaries(expr);
+  if (const auto *op = dyn_cast<CXXOperatorCallExpr>(expr)) {
+    return op->getOperator() == OO_Plus && op->getNumArgs() == 2 &&
+           isFrontIterator(op->getArg(0));
+  }
+  const auto *call = dyn_cast<CXXMemberCallExpr>(expr);
+  if (!call || !call->getMethodDecl() ||
+      !call->getMethodDecl()->getIdentifier()) {
+    return false;
+  }
+  StringRef name = call->getMethodDecl()->getName();
+  StringRef className =
+      getStdClassName(call->getImplicitObjectArgument()->getType());
+  return (name == "begin" || name == "cbegin") &&
+         (className == "vector" || className == "basic_string");
+}
+
+// Whether expr is c.begin() of any container.
+bool isBeginOfContainer(const Expr *expr) {
+  const auto *call = dyn_cast<CXXMemberCallExpr>(ignoreTemporaries(expr));
+  if (!call || !call->getMethodDecl() ||
+      !call->getMethodDecl()->getIdentifier()) {
+    return false;
+  }
+  StringRef name = call->getMethodDecl()->getName();
+  return (name == "begin" || name == "cbegin") &&
+         !getStdClassName(call->getImplicitObjectArgument()->getType())
+              .empty();
+}
+
+const ValueDecl *getReferencedDecl(const Expr *expr) {
+  const auto *ref = dyn_cast<DeclRefExpr>(ignoreTemporaries(expr));
+  return ref ? ref->getDecl() : nullptr;
+}
+
+class LinearInLoopChecker : public Checker {
+public:
+  StringRef getName() const override { return "linear_in_loop"; }
+
+  void registerDiagnostics(DiagnosticRegistry &registry) override {
+    eraseFrontID = registry.add(
+        *this, DiagnosticsEngine::Error,
+        "Erasing before the back of a vector or string moves all elements "
+        "after it, which makes this loop nest of depth %0 O(n^%1). Use a "
+        "deque.");
+    insertFrontID = registry.add(
+        *this, DiagnosticsEngine::Error,
+        "Inserting before the back of a vector or string moves all elements "
+        "after it, which makes this loop nest of depth %0 O(n^%1). Use a "
+        "deque, or reserve() the final size before the loop, insert at the "
+        "back and reverse.");
+    searchID = registry.add(
+        *this, DiagnosticsEngine::Error,
+        "%2 is a linear search, which makes this loop nest of depth %0 "
+        "O(n^%1). Use a set or a map of counts.");
+    concatID = registry.add(
+        *this, DiagnosticsEngine::Error,
+        "s = s + x copies the string, which makes this loop nest of depth %0 "
+        "O(n^%1). Use +=, and reserve() the final length before the loop if "
+        "it is known.");
+  }
+
+  void visitStmt(const Stmt *stmt, const TraversalContext &context) override {
+    const auto *call = dyn_cast<CallExpr>(stmt);
+    if (!call) {
+      return;
+    }
+    if (const auto *memberCall = dyn_cast<CXXMemberCallExpr>(call)) {
+      visitMemberCall(memberCall, context);
+    } else if (const auto *op = dyn_cast<CXXOperatorCallExpr>(call)) {
+      if (!isSelfConcatenation(op)) {
+        return;
+      }
+      unsigned depth = context.getLoopDepth();
+      if (depth > 0) {
+        auto builder = report(context, op->getOperatorLoc(), concatID, depth);
+        addConcatenationFixIt(op, builder);
+      }
+    } else {
+      visitSearch(call, context);
+    }
+  }
+
+private:
+  unsigned eraseFrontID = 0;
+  unsigned insertFrontID = 0;
+  unsigned searchID = 0;
+  unsigned concatID = 0;
+
+  void visitMemberCall(const CXXMemberCallExpr *call,
+                       const TraversalContext &context) {
+    const CXXMethodDecl *method = call->getMethodDecl();
+    if (!method || !method->getIdentifier() || call->getNumArgs() == 0) {
+      return;
+    }
+    StringRef name = method->getName();
+    unsigned diagID = 0;
+    if (name == "erase") {
+      diagID = eraseFrontID;
+    } else if (name == "insert" || name == "emplace") {
+      diagID = insertFrontID;
+    }
+    if (!diagID || !isFrontIterator(call->getArg(0))) {
+      return;
+    }
+    unsigned depth = context.getLoopDepth();
+    if (depth > 0) {
+      report(context, call->getLocStart(), diagID, depth);
+    }
+  }
+
+  void visitSearch(const CallExpr *call, const TraversalContext &context) {
+    const FunctionDecl *function = call->getDirectCallee();
+    if (!function || !function->getIdentifier() ||
+        !function->isInStdNamespace() || call->getNumArgs() == 0) {
+      return;
+    }
+    bool isSearch = StringSwitch<bool>(function->getName())
+                        .Cases("find", "find_if", "count", "count_if", true)
+                        .Default(false);
+    if (!isSearch || !isBeginOfContainer(call->getArg(0))) {
+      return;
+    }
+    unsigned depth = context.getLoopDepth();
+    if (depth > 0) {
+      report(context, call->getLocStart(), searchID, depth)
+          << ("std::" + function->getName()).str();
+    }
+  }
+
+  DiagnosticBuilder report(const TraversalContext &context,
+                           SourceLocation location, unsigned diagID,
+                           unsigned depth) {
+    return context.getDiagnostics().Report(location, diagID)
+           << depth << depth + 1;
+  }
+
+  // s = s + x on a string.
+  static bool isSelfConcatenation(const CXXOperatorCallExpr *op) {
+    if (op->getOperator() != OO_Equal || op->getNumArgs() != 2 ||
+        getStdClassName(op->getArg(0)->getType()) != "basic_string") {
+      return false;
+    }
+    const auto *plus = dyn_cast<CXXOperatorCallExpr>(
+        ignoreTemporaries(op->getArg(1)));
+    if (!plus || plus->getOperator() != OO_Plus || plus->getNumArgs() != 2) {
+      return false;
+    }
+    const ValueDecl *target = getReferencedDecl(op->getArg(0));
+    return target && target == getReferencedDecl(plus->getArg(0));
+  }
+
+  // Replaces "= s +" with "+=", and "= (s +" with "+=" along with the
+  // matching ")".
+  static void addConcatenationFixIt(const CXXOperatorCallExpr *op,
+                                    DiagnosticBuilder &builder) {
+    std::vector<SourceLocation> rParens;
+    const Expr *value = ignoreTemporaries(op->getArg(1), true);
+    while (const auto *paren = dyn_cast<ParenExpr>(value)) {
+      rParens.push_back(paren->getRParen());
+      value = ignoreTemporaries(paren->getSubExpr(), true);
+    }
+    const auto *plus = dyn_cast<CXXOperatorCallExpr>(value);
+    if (!plus || plus != ignoreTemporaries(op->getArg(1))) {
+      return;
+    }
+    SourceLocation begin = op->getOperatorLoc();
+    SourceLocation end = plus->getArg(1)->getLocStart();
+    bool inFile = begin.isFileID() && end.isFileID() &&
+                  std::all_of(rParens.begin(), rParens.end(),
+                              [](SourceLocation rParen) {
+                                return rParen.isFileID();
+                              });
+    if (!inFile) {
+      return;
+    }
+    builder.AddFixItHint(FixItHint::CreateReplacement(
+        CharSourceRange::getCharRange(begin, end), "+= "));
+    for (SourceLocation rParen : rParens) {
+      builder.AddFixItHint(FixItHint::CreateRemoval(
+          CharSourceRange::getTokenRange(rParen, rParen)));
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Checker> createLinearInLoopChecker() {
+  return llvm::make_unique<LinearInLoopChecker>();
+}
+
+} // namespace complint
@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+// Suggests double type to be used instead of float.
+//------------------------------------------------------------------------------
+#include "clang/AST/AST.h"
+#include "clang/AST/TypeLoc.h"
+#include "clang/Basic/Diagnostic.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/ASTMatchers/ASTMatchers.h"
+
+#include "checker.h"
+
+namespace complint {
+namespace {
+
+using namespace clang;
+using namespace ast_matchers;
+
+constexpr char VAR_DECL_BINDING[] = "vardecl";
+constexpr char FUNC_DECL_BINDING[] = "funcdecl";
+
+// float, also through typedefs, qualifiers and arrays. Only the canonical
+// type is inspected, nothing is printed.
+AST_MATCHER(QualType, isFloatType) {
+  return Node.getCanonicalType()->getBaseElementTypeUnsafe()
+      ->isSpecificBuiltinType(BuiltinType::Float);
+}
+
+// The written "float" of a declaration, or an invalid range if the type is
+// spelled through a typedef, which is where it should be fixed instead.
+SourceRange getFloatKeywordRange(TypeLoc typeLoc) {
+  while (auto arrayLoc = typeLoc.getAs<ArrayTypeLoc>()) {
+    typeLoc = arrayLoc.getElementLoc();
+  }
+  typeLoc = typeLoc.getUnqualifiedLoc();
+  if (!typeLoc.getAs<BuiltinTypeLoc>()) {
+    return SourceRange();
+  }
+  return typeLoc.getSourceRange();
+}
+
+class DeclHandler : public MatchFinder::MatchCallback {
+public:
+  DeclHandler() {}
+
+  StringRef getID() const override { return "no_float"; }
+
+  void setDiagID(unsigned diagID) { ID = diagID; }
+
+  virtual void run(const MatchFinder::MatchResult &result) {
+    auto& diagnostics = result.Context->getDiagnostics();
+
+    if (const VarDecl *variableDecl =
+          result.Nodes.getNodeAs<VarDecl>(VAR_DECL_BINDING)) {
+      auto builder = diagnostics.Report(variableDecl->getLocStart(), ID);
+      SourceRange sourceRange = getFloatKeywordRange(
+        variableDecl->getTypeSourceInfo()->getTypeLoc());
+      if (sourceRange.isValid()) {
+        builder.AddFixItHint(
+          FixItHint::CreateReplacement(sourceRange, "double"));
+      }
+    }
+
+    if (const FunctionDecl *funcDecl =
+          result.Nodes.getNodeAs<FunctionDecl>(FUNC_DECL_BINDING)) {
+      auto builder = diagnostics.Report(funcDecl->getLocStart(), ID);
+      if (isa<BuiltinType>(funcDecl->getReturnType().getTypePtr())) {
+        const auto hint = FixItHint::CreateReplacement(
+          funcDecl->getReturnTypeSourceRange(), "double");
+        builder.AddFixItHint(hint);
+      }
+    }
+  }
+
+private:
+  unsigned ID = 0;
+};
+
+class NoFloatChecker : public Checker {
+public:
+  StringRef getName() const override { return "no_float"; }
+
+  void registerDiagnostics(DiagnosticRegistry &registry) override {
+    callback.setDiagID(registry.add(*this, DiagnosticsEngine::Error,
+                                    "Use double for better precision."));
+  }
+
+  void registerMatchers(CheckerMatchFinder &finder) override {
+    finder.addMatcher(
+      decl(
+        isExpansionInMainFile(),
+        anyOf(
+          varDecl(hasType(isFloatType())).bind(VAR_DECL_BINDING),
+          functionDecl(returns(isFloatType())).bind(FUNC_DECL_BINDING)
+        )
+      ),
+      &callback
+    );
+  }
+
+private:
+  DeclHandler callback;
+};
+
+} // namespace
+
+std::unique_ptr<Checker> createNoFloatChecker() {
+  return llvm::make_unique<NoFloatChecker>();
+}
+
+} // namespace complint
@@ -0,0 +1,245 @@
+//------------------------------------------------------------------------------
+// Common interface of all competitive-linter checks.
+//
+// A checker inspects the text of the main file, the main-file part of the AST
+// (through matchers or visit hooks), or both. LintConsumer drives every
+// checker of a translation unit from a single read of the main-file buffer and
+// a single MainFileTraversal, so adding a checker doesn't add another walk
+// over the AST.
+//------------------------------------------------------------------------------
+#ifndef COMPETITIVE_LINT_CHECKER_H
+#define COMPETITIVE_LINT_CHECKER_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "clang/AST/ASTContext.h"
+#include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/Basic/Diagnostic.h"
+#include "clang/Basic/SourceManager.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringRef.h"
+
+#include "source_scan.h"
+
+namespace complint {
+
+// Version of the checker output. Bump it whenever a checker reports something
+// different for the same input, so cached results are invalidated.
+constexpr char LINTER_VERSION[] = "6";
+
+class Checker;
+
+// Creates the custom diagnostics of the checkers, once per translation unit,
+// and remembers which checker each of them belongs to.
+class DiagnosticRegistry {
+public:
+  explicit DiagnosticRegistry(clang::DiagnosticsEngine &diagnostics)
+      : diagnostics(diagnostics) {}
+
+  unsigned add(const Checker &checker, clang::DiagnosticsEngine::Level level,
+               llvm::StringRef message);
+
+  // Name of the checker which added the diagnostic, or an empty string for
+  // diagnostics of the compiler.
+  llvm::StringRef getCheckerName(unsigned diagID) const;
+
+private:
+  clang::DiagnosticsEngine &diagnostics;
+  llvm::DenseMap<unsigned, llvm::StringRef> owners;
+};
+
+// Where MainFileTraversal currently is. Checkers should use it instead of the
+// hasParent() and hasAncestor() matchers, which make clang build the parent
+// map of the whole translation unit, headers included.
+class TraversalContext {
+public:
+  explicit TraversalContext(clang::ASTContext &astContext)
+      : astContext(astContext) {}
+
+  clang::ASTContext &getASTContext() const { return astContext; }
+  clang::DiagnosticsEngine &getDiagnostics() const {
+    return astContext.getDiagnostics();
+  }
+
+  // Innermost function definition containing the node, if any.
+  const clang::FunctionDecl *getFunction() const { return function; }
+  // Statements of the current function enclosing the node, outermost first.
+  // A visited statement is the last one itself.
+  llvm::ArrayRef<const clang::Stmt *> getStmtStack() const {
+    return stmtStack;
+  }
+  // Number of enclosing loops which execute the node on every iteration.
+  // The init-statement of a for loop and the range of a range-based for loop
+  // only run once, so they don't count.
+  unsigned getLoopDepth() const;
+
+private:
+  friend class MainFileTraversal;
+
+  clang::ASTContext &astContext;
+  const clang::FunctionDecl *function = nullptr;
+  std::vector<const clang::Stmt *> stmtStack;
+};
+
+// The MatchFinder shared by the checkers. While a match counter is set, the
+// callbacks added to it count the nodes they match there, for the statistics
+// (see lint_stats.h); otherwise it is a plain MatchFinder.
+class CheckerMatchFinder : public clang::ast_matchers::MatchFinder {
+public:
+  explicit CheckerMatchFinder(MatchFinderOptions options = MatchFinderOptions())
+      : MatchFinder(std::move(options)) {}
+
+  void setMatchCounter(uint64_t *matches) { this->matches = matches; }
+
+  template <typename MatcherT>
+  void addMatcher(const MatcherT &matcher, MatchCallback *callback) {
+    if (matches) {
+      countingCallbacks.push_back(
+          llvm::make_unique<CountingCallback>(callback, matches));
+      callback = countingCallbacks.back().get();
+    }
+    MatchFinder::addMatcher(matcher, callback);
+  }
+
+private:
+  // Forwards everything to callback, with its ID, so the profiling of the
+  // matchers still charges the time to its checker.
+  class CountingCallback : public MatchCallback {
+  public:
+    CountingCallback(MatchCallback *callback, uint64_t *matches)
+        : callback(callback), matches(matches) {}
+
+    void run(const MatchResult &result) override {
+      ++*matches;
+      callback->run(result);
+    }
+    void onStartOfTranslationUnit() override {
+      callback->onStartOfTranslationUnit();
+    }
+    void onEndOfTranslationUnit() override {
+      callback->onEndOfTranslationUnit();
+    }
+    llvm::StringRef getID() const override { return callback->getID(); }
+
+  private:
+    MatchCallback *callback;
+    uint64_t *matches;
+  };
+
+  uint64_t *matches = nullptr;
+  std::vector<std::unique_ptr<CountingCallback>> countingCallbacks;
+};
+
+class Checker {
+public:
+  virtual ~Checker() {}
+
+  // Name of the check. It is the same as the name of its standalone plugin.
+  virtual llvm::StringRef getName() const = 0;
+
+  // Creates the diagnostics of the check. Called once per translation unit,
+  // before any of the hooks below.
+  virtual void registerDiagnostics(DiagnosticRegistry &registry) {}
+
+  // Inspects the text of the main file. Called once, before parsing starts.
+  // The scan of the buffer is shared by all checkers.
+  virtual void checkSource(clang::DiagnosticsEngine &diagnostics,
+                           clang::SourceManager &sourceManager,
+                           clang::FileID file, const SourceScan &scan) {}
+
+  // Whether checkSource is implemented. The buffer is only scanned if one of
+  // the checkers of a translation unit inspects it.
+  virtual bool checksSource() const { return false; }
+
+  // Whether checkComment is implemented.
+  virtual bool checksComments() const { return false; }
+
+  // Inspects a comment of the main file, e.g. "// text" or "/* text */".
+  // During a compile, it is called by a CommentHandler of the preprocessor
+  // as the lexer skips the comment, so the buffer isn't searched again.
+  // Without a compile, the comments come from the scan of the buffer.
+  virtual void checkComment(clang::DiagnosticsEngine &diagnostics,
+                            clang::SourceManager &sourceManager,
+                            clang::SourceRange range, llvm::StringRef text) {}
+
+  // Sets an option of the check from the configuration (see lint_config.h).
+  // Returns false if there is no such option or the value is invalid.
+  virtual bool setOption(llvm::StringRef name, llvm::StringRef value) {
+    return false;
+  }
+
+  // Whether the findings of the check in the top-level declaration decl can
+  // depend on code outside of it, e.g. on the functions it calls. The
+  // incremental mode (see incremental_lint.h) then traverses decl after
+  // every edit of the buffer, not only after edits of decl itself.
+  virtual bool isNonLocal(const clang::Decl *decl) const { return false; }
+
+  // Whether the findings of the check come from a walk of the program, e.g.
+  // of main and the functions it calls, so they can be in declarations
+  // which weren't traversed. The incremental mode then never reuses them;
+  // isNonLocal has to make the walk run after every edit, which reports
+  // all of them again.
+  virtual bool isProgramWide() const { return false; }
+
+  // Whether editing the buffer from oldSource to newSource can change the
+  // findings of the check outside of the edit, e.g. by adding a comment
+  // which turns it off. The incremental mode then lints the whole buffer,
+  // even after an edit of comments only.
+  virtual bool isGlobalEdit(llvm::StringRef oldSource,
+                            llvm::StringRef newSource) const {
+    return false;
+  }
+
+  // Makes all diagnostics of the check use level instead of the one they
+  // are registered with.
+  void overrideLevel(clang::DiagnosticsEngine::Level level) {
+    levelOverride = level;
+  }
+  llvm::Optional<clang::DiagnosticsEngine::Level> getLevelOverride() const {
+    return levelOverride;
+  }
+
+  // Adds the AST matchers of the check to the shared finder. They are run on
+  // each declaration and statement of the main file, so only declaration and
+  // statement matchers are supported.
+  virtual void registerMatchers(CheckerMatchFinder &finder) {}
+
+  // Called for each declaration and statement of the main file, in the order
+  // of the traversal.
+  virtual void visitDecl(const clang::Decl *decl,
+                         const TraversalContext &context) {}
+  virtual void visitStmt(const clang::Stmt *stmt,
+                         const TraversalContext &context) {}
+
+private:
+  llvm::Optional<clang::DiagnosticsEngine::Level> levelOverride;
+};
+
+typedef std::vector<std::unique_ptr<Checker>> CheckerList;
+
+std::unique_ptr<Checker> createGotoChecker();
+std::unique_ptr<Checker> createFloatingPointCompChecker();
+std::unique_ptr<Checker> createNoFloatChecker();
+std::unique_ptr<Checker> createConsecutiveNewlinesChecker();
+std::unique_ptr<Checker> createFastCinChecker();
+std::unique_ptr<Checker> createDebugMacroChecker();
+std::unique_ptr<Checker> createFlushInLoopChecker();
+std::unique_ptr<Checker> createContainerByValueChecker();
+std::unique_ptr<Checker> createDeepRecursionChecker();
+std::unique_ptr<Checker> createLinearInLoopChecker();
+std::unique_ptr<Checker> createIntegerMathChecker();
+std::unique_ptr<Checker> createAllocInLoopChecker();
+std::unique_ptr<Checker> createInputVolumeChecker();
+
+// Creates one instance of every available checker.
+CheckerList createAllCheckers();
+
+} // namespace complint
+
+#endif // COMPETITIVE_LINT_CHECKER_H
@@ -0,0 +1,46 @@
+//------------------------------------------------------------------------------
+// List of all checkers known to the linter and their diagnostics.
+//------------------------------------------------------------------------------
+#include "checker.h"
+
+namespace complint {
+
+using namespace clang;
+
+unsigned DiagnosticRegistry::add(const Checker &checker,
+                                 DiagnosticsEngine::Level level,
+                                 StringRef message) {
+  if (auto levelOverride = checker.getLevelOverride()) {
+    level = *levelOverride;
+  }
+  // DiagnosticsEngine::getCustomDiagID() only takes string literals.
+  unsigned diagID = diagnostics.getDiagnosticIDs()->getCustomDiagID(
+      static_cast<DiagnosticIDs::Level>(level), message);
+  owners[diagID] = checker.getName();
+  return diagID;
+}
+
+StringRef DiagnosticRegistry::getCheckerName(unsigned diagID) const {
+  auto it = owners.find(diagID);
+  return it == owners.end() ? StringRef() : it->second;
+}
+
+CheckerList createAllCheckers() {
+  CheckerList checkers;
+  checkers.push_back(createDebugMacroChecker());
+  checkers.push_back(createFloatingPointCompChecker());
+  checkers.push_back(createConsecutiveNewlinesChecker());
+  checkers.push_back(createNoFloatChecker());
+  checkers.push_back(createGotoChecker());
+  checkers.push_back(createFastCinChecker());
+  checkers.push_back(createFlushInLoopChecker());
+  checkers.push_back(createContainerByValueChecker());
+  checkers.push_back(createDeepRecursionChecker());
+  checkers.push_back(createLinearInLoopChecker());
+  checkers.push_back(createIntegerMathChecker());
+  checkers.push_back(createAllocInLoopChecker());
+  checkers.push_back(createInputVolumeChecker());
+  return checkers;
+}
+
+} // namespace complint
@@ -0,0 +1,508 @@
+//------------------------------------------------------------------------------
+// comp-lint: standalone batch linter built on LibTooling.
+//
+// Lints many submissions in one process on a pool of worker threads instead
+// of starting a clang process and loading the plugins for every file. For
+// example:
+//
+// $ build/comp-lint submissions/ extra/a.cc -j 16
+// $ build/comp-lint -file-list=queue.txt -extra-arg=-std=c++17
+//
+// Each worker owns a FileManager which is reused for all of its jobs, so the
+// lookups of the system headers are cached across submissions. The output of
+// every file is printed as one block, in the order of the inputs.
+//
+// The include prologue of each submission is precompiled once and cached on
+// disk (see pch_cache.h). -print-pch-args exposes the cache to the plugin
+// flow of run_all.sh.
+//
+// With -result-cache, the results are also cached by the content of the
+// submission (see result_cache.h), and files linted before aren't parsed.
+//
+// -text-only runs just the checks of the source text, without preprocessing
+// or parsing (see text_lint.h). Editors can pipe the unsaved buffer as "-".
+//
+// -format=jsonl or -format=sarif writes the findings as records instead of
+// printing the diagnostics (see finding_writer.h), to stdout or to -o.
+//
+// -fix applies the fix-its of the checkers to all inputs in one pass, and
+// -fix-diff prints them as a unified diff instead (see fix_applier.h):
+//
+// $ build/comp-lint submissions/ -fix-diff | patch -p0
+//
+// The checkers are configured by the .complint.yaml of the working directory
+// or -config, and by -checker-arg, which takes the plugin arguments of
+// lint_config.h, e.g. -checker-arg=disable=goto.
+//
+// -max-memory admits the workers' jobs by their estimated memory, so huge
+// generated submissions don't run together; a file which doesn't fit on its
+// own is only checked as text. -elide-initializers compiles them with their
+// constant tables blanked out (see large_input.h).
+//
+// -serve=<socket> keeps all of this warm in a daemon which answers lint
+// requests on a Unix socket (see lint_server.h):
+//
+// $ build/comp-lint -serve=/tmp/comp-lint.sock -result-cache=/tmp/results &
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "clang/Basic/FileManager.h"
+#include "clang/Basic/Version.h"
+
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "finding_writer.h"
+#include "findings.h"
+#include "fix_applier.h"
+#include "large_input.h"
+#include "lint_config.h"
+#include "lint_consumer.h"
+#include "lint_runner.h"
+#include "lint_server.h"
+#include "pch_cache.h"
+#include "result_cache.h"
+
+// The clang driver next to which the builtin headers are installed. Set by
+// the Makefile from LLVM_BIN_PATH.
+#ifndef COMP_LINT_CLANG_PATH
+#define COMP_LINT_CLANG_PATH "clang++"
+#endif
+
+namespace {
+
+using namespace clang;
+using namespace complint;
+
+llvm::cl::OptionCategory compLintCategory("comp-lint options");
+
+llvm::cl::list<std::string> inputPaths(
+    llvm::cl::Positional, llvm::cl::desc("<file or directory>..."),
+    llvm::cl::cat(compLintCategory));
+
+llvm::cl::opt<std::string> fileList(
+    "file-list",
+    llvm::cl::desc("Read the paths to lint from this file, one per line "
+                   "('-' for stdin)."),
+    llvm::cl::cat(compLintCategory));
+
+llvm::cl::opt<unsigned> jobs(
+    "j", llvm::cl::desc("Number of worker threads (default: one per core)."),
+    llvm::cl::init(0), llvm::cl::cat(compLintCategory));
+
+llvm::cl::opt<std::string> clangPath(
+    "clang",
+    llvm::cl::desc("Clang driver used to locate the builtin headers."),
+    llvm::cl::init(COMP_LINT_CLANG_PATH), llvm::cl::cat(compLintCategory));
+
+llvm::cl::list<std::string> extraArgs(
+    "extra-arg",
+    llvm::cl::desc("Additional argument to append to the compiler command "
+                   "line."),
+    llvm::cl::cat(compLintCategory));
+
+llvm::cl::opt<std::string> pchCacheDirectory(
+    "pch-cache",
+    llvm::cl::desc("Directory of the precompiled prologue headers "
+                   "(default: <cache directory>/pch)."),
+    llvm::cl::cat(compLintCategory));
+
+llvm::cl::opt<bool> noPCH(
+    "no-pch",
+    llvm::cl::desc("Don't precompile the include prologues of the inputs."),
+    llvm::cl::cat(compLintCategory));
+
+llvm::cl::opt<bool> printPCHArgs(
+    "print-pch-args",
+    llvm::cl::desc("Don't lint. Print the compiler arguments which make clang "
+                   "use the cached PCH for the single input file."),
+    llvm::cl::cat(compLintCategory));
+
+llvm::cl::opt<std::string> resultCacheDirectory(
+    "result-cache",
+    llvm::cl::desc("Cache the results by the content of the inputs in this "
+                   "directory."),
+    llvm::cl::cat(compLintCategory));
+
+llvm::cl::opt<unsigned> resultCacheSize(
+    "result-cache-size",
+    llvm::cl::desc("Size limit of the result cache in megabytes "
+                   "(default: 1024)."),
+    llvm::cl::init(1024), llvm::cl::cat(compLintCategory));
+
+llvm::cl::opt<bool> textOnly(
+    "text-only",
+    llvm::cl::desc("Only run the checks of the source text. Nothing is "
+                   "preprocessed or parsed, so this takes microseconds."),
+    llvm::cl::cat(compLintCategory));
+
+llvm::cl::opt<std::string> outputFormat(
+    "format",
+    llvm::cl::desc("Output format: text (default), jsonl or sarif."),
+    llvm::cl::init("text"), llvm::cl::cat(compLintCategory));
+
+llvm::cl::opt<std::string> outputPath(
+    "o",
+    llvm::cl::desc("Write the jsonl or sarif output to this file instead of "
+                   "stdout."),
+    llvm::cl::init("-"), llvm::cl::cat(compLintCategory));
+
+llvm::cl::opt<std::string> serveSocket(
+    "serve",
+    llvm::cl::desc("Run as a daemon serving lint requests on this Unix "
+                   "socket (see lint_server.h)."),
+    llvm::cl::value_desc("socket"), llvm::cl::cat(compLintCategory));
+
+llvm::cl::opt<bool> applyFixes(
+    "fix",
+    llvm::cl::desc("Apply the fix-its of the checkers to the inputs."),
+    llvm::cl::cat(compLintCategory));
+
+llvm::cl::opt<bool> diffFixes(
+    "fix-diff",
+    llvm::cl::desc("Print the fix-its of the checkers as a unified diff "
+                   "instead of the diagnostics."),
+    llvm::cl::cat(compLintCategory));
+
+llvm::cl::opt<std::string> configPath(
+    "config",
+    llvm::cl::desc("Read the checker configuration from this file instead of "
+                   "the .complint.yaml of the working directory."),
+    llvm::cl::cat(compLintCategory));
+
+llvm::cl::list<std::string> checkerArgs(
+    "checker-arg",
+    llvm::cl::desc("Configure the checkers, e.g. disable=goto or "
+                   "consecutive_newlines.max_empty_lines=3."),
+    llvm::cl::cat(compLintCategory));
+
+llvm::cl::opt<unsigned> maxMemory(
+    "max-memory",
+    llvm::cl::desc("Estimated memory of the jobs run together in "
+                   "megabytes, 0 for no limit (default). Files estimated to "
+                   "need more on their own are only checked as text."),
+    llvm::cl::init(0), llvm::cl::cat(compLintCategory));
+
+llvm::cl::opt<unsigned> elideInitializers(
+    "elide-initializers",
+    llvm::cl::desc("Don't parse the constant initializer lists and string "
+                   "literals of at least this many kilobytes, except those "
+                   "of arrays without a bound. The AST checks don't see "
+                   "their values. 0 parses everything (default)."),
+    llvm::cl::init(0),
+    llvm::cl::cat(compLintCategory));
+
+bool isSourceFile(StringRef path) {
+  StringRef extension = llvm::sys::path::extension(path);
+  return extension == ".cc" || extension == ".cpp" || extension == ".cxx" ||
+         extension == ".C";
+}
+
+// Adds path, or all sources below it if it is a directory, to files.
+void collectInputs(StringRef path, std::vector<std::string> &files) {
+  if (!llvm::sys::fs::is_directory(path)) {
+    files.push_back(path.str());
+    return;
+  }
+
+  std::vector<std::string> sources;
+  std::error_code error;
+  for (llvm::sys::fs::recursive_directory_iterator it(path, error), end;
+       it != end && !error; it.increment(error)) {
+    if (isSourceFile(it->path()) && !llvm::sys::fs::is_directory(it->path())) {
+      sources.push_back(it->path());
+    }
+  }
+  if (error) {
+    llvm::errs() << "comp-lint: " << path << ": " << error.message() << "\n";
+  }
+  std::sort(sources.begin(), sources.end());
+  files.insert(files.end(), sources.begin(), sources.end());
+}
+
+bool readFileList(StringRef listPath, std::vector<std::string> &files) {
+  auto buffer = llvm::MemoryBuffer::getFileOrSTDIN(listPath);
+  if (!buffer) {
+    llvm::errs() << "comp-lint: " << listPath << ": "
+                 << buffer.getError().message() << "\n";
+    return false;
+  }
+  SmallVector<StringRef, 64> lines;
+  (*buffer)->getBuffer().split(lines, '\n', -1, false);
+  for (StringRef line : lines) {
+    line = line.trim();
+    if (!line.empty()) {
+      collectInputs(line, files);
+    }
+  }
+  return true;
+}
+
+std::string getPCHFor(PCHCache &pchCache, StringRef path) {
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer) {
+    return "";
+  }
+  return pchCache.getPCHFor((*buffer)->getBuffer());
+}
+
+// Everything besides the source which the results depend on.
+std::string
+getResultConfiguration(const std::vector<std::string> &commandLine,
+                       const LintConfig &config) {
+  std::string configuration;
+  llvm::raw_string_ostream os(configuration);
+  os << LINTER_VERSION << '\n' << getClangFullVersion() << '\n';
+  for (const auto &checker : createAllCheckers()) {
+    os << checker->getName() << ' ';
+  }
+  os << '\n' << config.getFingerprint();
+  os << '\n' << maxMemory << ' ' << elideInitializers;
+  for (const auto &arg : commandLine) {
+    os << '\n' << arg;
+  }
+  return os.str();
+}
+
+class BatchLinter {
+public:
+  BatchLinter(std::vector<std::string> files, const LintRunner &runner,
+              FindingWriter *writer)
+      : files(std::move(files)), runner(runner), writer(writer),
+        outputs(this->files.size()), done(this->files.size(), false) {}
+
+  // Applies the fix-its of every file after linting it. In Diff mode, the
+  // diff is printed instead of the diagnostics.
+  void setFixMode(FixMode mode) {
+    fixing = true;
+    fixMode = mode;
+  }
+
+  // Lints all files and returns the number of files with diagnostics.
+  unsigned run(unsigned threadCount) {
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threadCount; ++i) {
+      workers.emplace_back([this] { work(); });
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    if (fixing) {
+      llvm::errs() << "comp-lint: "
+                   << (fixMode == FixMode::Apply ? "applied" : "found")
+                   << " the fix-its of " << fixesApplied << " findings in "
+                   << filesFixed << " files";
+      if (fixesSkipped) {
+        llvm::errs() << ", skipped " << fixesSkipped
+                     << " overlapping ones; run again to apply them";
+      }
+      llvm::errs() << "\n";
+    }
+    return filesWithDiagnostics;
+  }
+
+private:
+  std::vector<std::string> files;
+  const LintRunner &runner;
+  // Null when the diagnostics are printed as text.
+  FindingWriter *writer;
+
+  bool fixing = false;
+  FixMode fixMode = FixMode::Apply;
+
+  std::atomic<size_t> nextJob{0};
+  std::atomic<unsigned> filesWithDiagnostics{0};
+  std::atomic<unsigned> fixesApplied{0};
+  std::atomic<unsigned> fixesSkipped{0};
+  std::atomic<unsigned> filesFixed{0};
+
+  std::mutex outputMutex;
+  std::vector<LintResult> outputs;
+  std::vector<bool> done;
+  size_t nextToPrint = 0;
+
+  void work() {
+    FileSystemOptions fileSystemOptions;
+    IntrusiveRefCntPtr<FileManager> fileManager(
+        new FileManager(fileSystemOptions));
+
+    for (size_t job = nextJob++; job < files.size(); job = nextJob++) {
+      LintResult result = fixing ? lintAndFix(*fileManager, files[job])
+                                 : runner.lintFile(*fileManager, files[job]);
+      if (hasProblems(result.findings)) {
+        ++filesWithDiagnostics;
+      }
+      publish(job, std::move(result));
+    }
+  }
+
+  // The fix-its are applied to the very buffer which was linted, so their
+  // offsets are right even if the file changed in between.
+  LintResult lintAndFix(FileManager &fileManager, const std::string &path) {
+    auto buffer = llvm::MemoryBuffer::getFile(path);
+    if (!buffer) {
+      return runner.lintFile(fileManager, path);
+    }
+    StringRef source = (*buffer)->getBuffer();
+    LintResult result = runner.lintBuffer(fileManager, path, source);
+
+    FixResult fix = fixFile(path, source, result.findings, fixMode);
+    fixesApplied += fix.applied;
+    fixesSkipped += fix.skipped;
+    if (fix.applied) {
+      ++filesFixed;
+    }
+    if (fixMode == FixMode::Diff) {
+      result.output = fix.diff;
+    } else if (!fix.error.empty()) {
+      std::lock_guard<std::mutex> lock(outputMutex);
+      llvm::errs() << "comp-lint: can't fix " << fix.error << "\n";
+    }
+    return result;
+  }
+
+  // Stores the output of a job and prints all outputs which are ready, so
+  // the results appear in input order no matter which worker finishes first.
+  void publish(size_t job, LintResult result) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    outputs[job] = std::move(result);
+    done[job] = true;
+    while (nextToPrint < files.size() && done[nextToPrint]) {
+      if (writer) {
+        writer->write(files[nextToPrint], outputs[nextToPrint].findings);
+      }
+      if (!writer || (fixing && fixMode == FixMode::Diff)) {
+        llvm::outs() << outputs[nextToPrint].output;
+      }
+      outputs[nextToPrint] = LintResult();
+      ++nextToPrint;
+    }
+    llvm::outs().flush();
+  }
+};
+
+}
+
+int main(int argc, const char **argv) {
+  llvm::cl::HideUnrelatedOptions(compLintCategory);
+  llvm::cl::ParseCommandLineOptions(argc, argv,
+                                    "Competitive programming linter.\n");
+
+  std::vector<std::string> files;
+  for (const auto &path : inputPaths) {
+    collectInputs(path, files);
+  }
+  if (!fileList.empty() && !readFileList(fileList, files)) {
+    return 1;
+  }
+  if (files.empty() && serveSocket.empty()) {
+    llvm::errs() << "comp-lint: no input files\n";
+    return 1;
+  }
+
+  OutputFormat format;
+  if (!parseOutputFormat(outputFormat, format)) {
+    llvm::errs() << "comp-lint: unknown output format " << outputFormat
+                 << "\n";
+    return 1;
+  }
+  if (applyFixes && diffFixes) {
+    llvm::errs() << "comp-lint: -fix and -fix-diff are exclusive\n";
+    return 1;
+  }
+  if (diffFixes && format != OutputFormat::Text && outputPath == "-") {
+    llvm::errs() << "comp-lint: -fix-diff prints to stdout, so the "
+                 << outputFormat << " output needs -o\n";
+    return 1;
+  }
+
+  LintConfig config;
+  std::vector<std::string> configArgs(checkerArgs.begin(), checkerArgs.end());
+  if (!configPath.empty()) {
+    configArgs.insert(configArgs.begin(), "config=" + configPath);
+  }
+  std::string configError;
+  if (!loadConfig(configArgs, config, configError)) {
+    llvm::errs() << "comp-lint: invalid configuration: " << configError
+                 << "\n";
+    return 1;
+  }
+
+  std::unique_ptr<PCHCache> pchCache;
+  if (!noPCH && !textOnly) {
+    std::string directory = pchCacheDirectory;
+    if (directory.empty()) {
+      directory = getDefaultCacheDirectory();
+      if (!directory.empty()) {
+        directory += "/pch";
+      }
+    }
+    std::vector<std::string> compileArgs(extraArgs.begin(), extraArgs.end());
+    pchCache = llvm::make_unique<PCHCache>(directory, clangPath, compileArgs);
+  }
+
+  if (printPCHArgs) {
+    if (files.size() != 1) {
+      llvm::errs() << "comp-lint: -print-pch-args takes exactly one file\n";
+      return 1;
+    }
+    std::string pch = pchCache ? getPCHFor(*pchCache, files[0]) : "";
+    if (!pch.empty()) {
+      llvm::outs() << "-include-pch " << pch << "\n";
+    }
+    return 0;
+  }
+
+  std::vector<std::string> commandLine = {clangPath, "-fsyntax-only"};
+  commandLine.insert(commandLine.end(), extraArgs.begin(), extraArgs.end());
+
+  unsigned threadCount = jobs ? jobs : std::thread::hardware_concurrency();
+
+  std::unique_ptr<ResultCache> resultCache;
+  if (!resultCacheDirectory.empty() && !textOnly) {
+    resultCache = llvm::make_unique<ResultCache>(
+        resultCacheDirectory, uint64_t(resultCacheSize) << 20,
+        getResultConfiguration(commandLine, config));
+  }
+  LintRunner runner(std::move(commandLine), pchCache.get(), resultCache.get(),
+                    textOnly, &config);
+  std::unique_ptr<MemoryBudget> memoryBudget;
+  if (maxMemory) {
+    memoryBudget = llvm::make_unique<MemoryBudget>(uint64_t(maxMemory) << 20);
+  }
+  runner.setLargeInputLimits(memoryBudget.get(),
+                             size_t(elideInitializers) << 10);
+
+  if (!serveSocket.empty()) {
+    std::string error;
+    LintServer server(runner, serveSocket);
+    if (!server.run(std::max(1u, threadCount), error)) {
+      llvm::errs() << "comp-lint: " << error << "\n";
+      return 1;
+    }
+    return 0;
+  }
+  threadCount = std::max(1u, std::min<unsigned>(threadCount, files.size()));
+
+  FindingWriter *writer = nullptr;
+  if (format != OutputFormat::Text) {
+    std::string error;
+    writer = FindingWriter::open(format, outputPath, error);
+    if (!writer) {
+      llvm::errs() << "comp-lint: " << error << "\n";
+      return 1;
+    }
+  }
+
+  BatchLinter linter(std::move(files), runner, writer);
+  if (applyFixes || diffFixes) {
+    linter.setFixMode(applyFixes ? FixMode::Apply : FixMode::Diff);
+  }
+  return linter.run(threadCount) == 0 ? 0 : 1;
+}
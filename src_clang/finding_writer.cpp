@@ -0,0 +1,231 @@
+//------------------------------------------------------------------------------
+// JSON Lines and SARIF writers.
+//------------------------------------------------------------------------------
+#include "finding_writer.h"
+
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+
+namespace complint {
+
+using namespace clang;
+
+namespace {
+
+// Checker of the diagnostics reported by the compiler itself.
+constexpr char COMPILER_CHECKER[] = "clang";
+
+StringRef getCheckerOf(const Finding &finding) {
+  return finding.checker.empty() ? StringRef(COMPILER_CHECKER)
+                                 : StringRef(finding.checker);
+}
+
+StringRef getFileOf(StringRef mainFile, const Finding &finding) {
+  return finding.file.empty() ? mainFile : StringRef(finding.file);
+}
+
+StringRef getLevelName(DiagnosticsEngine::Level level) {
+  switch (level) {
+  case DiagnosticsEngine::Ignored:
+    return "ignored";
+  case DiagnosticsEngine::Note:
+    return "note";
+  case DiagnosticsEngine::Remark:
+    return "remark";
+  case DiagnosticsEngine::Warning:
+    return "warning";
+  case DiagnosticsEngine::Error:
+    return "error";
+  case DiagnosticsEngine::Fatal:
+    return "fatal";
+  }
+  return "error";
+}
+
+// SARIF only knows error, warning, note and none.
+StringRef getSARIFLevel(DiagnosticsEngine::Level level) {
+  switch (level) {
+  case DiagnosticsEngine::Ignored:
+    return "none";
+  case DiagnosticsEngine::Note:
+  case DiagnosticsEngine::Remark:
+    return "note";
+  case DiagnosticsEngine::Warning:
+    return "warning";
+  case DiagnosticsEngine::Error:
+  case DiagnosticsEngine::Fatal:
+    return "error";
+  }
+  return "error";
+}
+
+std::mutex writerMutex;
+std::unique_ptr<FindingWriter> writer;
+OutputFormat writerFormat;
+
+} // namespace
+
+void writeJSONString(llvm::raw_ostream &os, StringRef str) {
+  os << '"';
+  for (char c : str) {
+    switch (c) {
+    case '"':
+      os << "\\\"";
+      break;
+    case '\\':
+      os << "\\\\";
+      break;
+    case '\n':
+      os << "\\n";
+      break;
+    case '\r':
+      os << "\\r";
+      break;
+    case '\t':
+      os << "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        os << llvm::format("\\u%04x", static_cast<unsigned char>(c));
+      } else {
+        os << c;
+      }
+    }
+  }
+  os << '"';
+}
+
+bool parseOutputFormat(StringRef name, OutputFormat &format) {
+  if (name == "text") {
+    format = OutputFormat::Text;
+  } else if (name == "jsonl") {
+    format = OutputFormat::JSONLines;
+  } else if (name == "sarif") {
+    format = OutputFormat::SARIF;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void writeFindingJSON(llvm::raw_ostream &os, StringRef mainFile,
+                      const Finding &finding) {
+  os << "{\"file\":";
+  writeJSONString(os, getFileOf(mainFile, finding));
+  os << ",\"checker\":";
+  writeJSONString(os, getCheckerOf(finding));
+  os << ",\"level\":\"" << getLevelName(finding.level) << "\",\"line\":"
+     << finding.line << ",\"column\":" << finding.column
+     << ",\"offset\":" << finding.offset << ",\"message\":";
+  writeJSONString(os, finding.message);
+  os << ",\"fixits\":[";
+  for (size_t i = 0; i < finding.fixIts.size(); ++i) {
+    const FindingFixIt &fixIt = finding.fixIts[i];
+    os << (i ? "," : "") << "{\"offset\":" << fixIt.offset
+       << ",\"length\":" << fixIt.length << ",\"replacement\":";
+    writeJSONString(os, fixIt.replacement);
+    os << '}';
+  }
+  os << "]}";
+}
+
+FindingWriter *FindingWriter::open(OutputFormat format, StringRef path,
+                                   std::string &error) {
+  std::lock_guard<std::mutex> lock(writerMutex);
+  if (writer) {
+    if (writerFormat != format || writer->path != path) {
+      error = "the output is already written to " + writer->path;
+      return nullptr;
+    }
+    return writer.get();
+  }
+
+  std::error_code errorCode;
+  auto flags = format == OutputFormat::JSONLines ? llvm::sys::fs::F_Append
+                                                 : llvm::sys::fs::F_None;
+  auto os = llvm::make_unique<llvm::raw_fd_ostream>(path, errorCode, flags);
+  if (errorCode) {
+    error = path.str() + ": " + errorCode.message();
+    return nullptr;
+  }
+  writer.reset(new FindingWriter(format, path.str(), std::move(os)));
+  writerFormat = format;
+  return writer.get();
+}
+
+FindingWriter::FindingWriter(OutputFormat format, std::string path,
+                             std::unique_ptr<llvm::raw_fd_ostream> os)
+    : format(format), path(std::move(path)), os(std::move(os)) {
+  if (format == OutputFormat::SARIF) {
+    *this->os << "{\"$schema\":\"https://json.schemastore.org/"
+                 "sarif-2.1.0.json\",\"version\":\"2.1.0\",\"runs\":[{"
+                 "\"tool\":{\"driver\":{\"name\":\"competitive_lint\","
+                 "\"version\":\""
+              << LINTER_VERSION << "\"}},\"results\":[";
+  }
+}
+
+FindingWriter::~FindingWriter() {
+  if (format == OutputFormat::SARIF) {
+    *os << "\n]}]}\n";
+  }
+  os->flush();
+}
+
+void FindingWriter::write(StringRef mainFile,
+                          const std::vector<Finding> &findings) {
+  std::lock_guard<std::mutex> lock(mutex);
+  for (const auto &finding : findings) {
+    if (format == OutputFormat::SARIF) {
+      writeSARIFResult(mainFile, finding);
+    } else {
+      writeFindingJSON(*os, mainFile, finding);
+      *os << '\n';
+    }
+  }
+  // One write per file keeps the records of concurrent compiler processes
+  // appending to the same file from interleaving.
+  os->flush();
+}
+
+void FindingWriter::writeSARIFResult(StringRef mainFile,
+                                     const Finding &finding) {
+  *os << (firstResult ? "\n" : ",\n");
+  firstResult = false;
+
+  *os << "{\"ruleId\":";
+  writeJSONString(*os, getCheckerOf(finding));
+  *os << ",\"level\":\"" << getSARIFLevel(finding.level)
+      << "\",\"message\":{\"text\":";
+  writeJSONString(*os, finding.message);
+  *os << "},\"locations\":[{\"physicalLocation\":{\"artifactLocation\":"
+         "{\"uri\":";
+  writeJSONString(*os, getFileOf(mainFile, finding));
+  *os << '}';
+  if (finding.line != 0) {
+    *os << ",\"region\":{\"startLine\":" << finding.line
+        << ",\"startColumn\":" << finding.column
+        << ",\"byteOffset\":" << finding.offset << '}';
+  }
+  *os << "}}]";
+
+  // Fix-its always edit the main file.
+  if (!finding.fixIts.empty()) {
+    *os << ",\"fixes\":[{\"artifactChanges\":[{\"artifactLocation\":"
+           "{\"uri\":";
+    writeJSONString(*os, mainFile);
+    *os << "},\"replacements\":[";
+    for (size_t i = 0; i < finding.fixIts.size(); ++i) {
+      const FindingFixIt &fixIt = finding.fixIts[i];
+      *os << (i ? "," : "") << "{\"deletedRegion\":{\"byteOffset\":"
+          << fixIt.offset << ",\"byteLength\":" << fixIt.length
+          << "},\"insertedContent\":{\"text\":";
+      writeJSONString(*os, fixIt.replacement);
+      *os << "}}";
+    }
+    *os << "]}]}]";
+  }
+  *os << '}';
+}
+
+} // namespace complint
@@ -0,0 +1,75 @@
+//------------------------------------------------------------------------------
+// Machine-readable output of the findings: JSON Lines or SARIF.
+//
+// The ingestion pipeline used to parse the text diagnostics clang prints to
+// stderr. Instead, every finding can be written as a record with the checker,
+// the location, the message and the fix-its. All records of a process go
+// through one buffered FindingWriter, which is flushed once per file rather
+// than once per diagnostic.
+//
+// JSON Lines: one object per finding, e.g.
+//   {"file":"a.cc","checker":"goto","level":"error","line":3,"column":5,
+//    "offset":42,"message":"Don't use goto statements.","fixits":[]}
+// Compiler diagnostics have "clang" as their checker. The output file is
+// opened for appending, so several compiler processes can share it.
+//
+// SARIF: one SARIF 2.1.0 log per process, with the findings as the results of
+// a single run.
+//------------------------------------------------------------------------------
+#ifndef COMPETITIVE_LINT_FINDING_WRITER_H
+#define COMPETITIVE_LINT_FINDING_WRITER_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "findings.h"
+
+namespace complint {
+
+enum class OutputFormat { Text, JSONLines, SARIF };
+
+// Parses "text", "jsonl" or "sarif".
+bool parseOutputFormat(llvm::StringRef name, OutputFormat &format);
+
+// Writes str as a quoted and escaped JSON string.
+void writeJSONString(llvm::raw_ostream &os, llvm::StringRef str);
+
+// Writes the JSON object of a finding of the file at mainFile, as in the JSON
+// Lines output but without the line break.
+void writeFindingJSON(llvm::raw_ostream &os, llvm::StringRef mainFile,
+                      const Finding &finding);
+
+class FindingWriter {
+public:
+  // The writer of the process. It is created by the first call, writing to
+  // path ("-" for stdout); later calls must ask for the same format and path.
+  // Returns null and sets error if the writer can't be opened.
+  static FindingWriter *open(OutputFormat format, llvm::StringRef path,
+                             std::string &error);
+
+  ~FindingWriter();
+
+  // Writes the findings of one file, whose path is mainFile. Thread-safe.
+  void write(llvm::StringRef mainFile, const std::vector<Finding> &findings);
+
+private:
+  FindingWriter(OutputFormat format, std::string path,
+                std::unique_ptr<llvm::raw_fd_ostream> os);
+
+  void writeSARIFResult(llvm::StringRef mainFile, const Finding &finding);
+
+  OutputFormat format;
+  std::string path;
+  std::unique_ptr<llvm::raw_fd_ostream> os;
+  std::mutex mutex;
+  bool firstResult = true;
+};
+
+} // namespace complint
+
+#endif // COMPETITIVE_LINT_FINDING_WRITER_H
@@ -0,0 +1,179 @@
+//------------------------------------------------------------------------------
+// Collection and serialization of findings.
+//------------------------------------------------------------------------------
+#include "findings.h"
+
+#include "clang/Basic/SourceManager.h"
+#include "clang/Lex/Lexer.h"
+
+namespace complint {
+
+using namespace clang;
+
+void FindingCollector::BeginSourceFile(const LangOptions &langOptions,
+                                       const Preprocessor *PP) {
+  this->langOptions = langOptions;
+  if (next) {
+    next->BeginSourceFile(langOptions, PP);
+  }
+}
+
+void FindingCollector::EndSourceFile() {
+  if (next) {
+    next->EndSourceFile();
+  }
+}
+
+void FindingCollector::finish() {
+  if (next) {
+    next->finish();
+  }
+}
+
+void FindingCollector::HandleDiagnostic(DiagnosticsEngine::Level level,
+                                        const Diagnostic &info) {
+  DiagnosticConsumer::HandleDiagnostic(level, info);
+  if (next) {
+    next->HandleDiagnostic(level, info);
+  }
+
+  Finding finding;
+  finding.level = level;
+  if (registry) {
+    finding.checker = registry->getCheckerName(info.getID()).str();
+  }
+  SmallString<256> message;
+  info.FormatDiagnostic(message);
+  finding.message = std::string(message.begin(), message.end());
+
+  if (info.hasSourceManager() && info.getLocation().isValid()) {
+    SourceManager &sourceManager = info.getSourceManager();
+    FileID mainFile = sourceManager.getMainFileID();
+    SourceLocation location = sourceManager.getFileLoc(info.getLocation());
+    PresumedLoc presumed = sourceManager.getPresumedLoc(location);
+    std::pair<FileID, unsigned> decomposed =
+        sourceManager.getDecomposedLoc(location);
+
+    finding.offset = decomposed.second;
+    if (presumed.isValid()) {
+      finding.line = presumed.getLine();
+      finding.column = presumed.getColumn();
+      if (decomposed.first != mainFile) {
+        finding.file = presumed.getFilename();
+      }
+    }
+
+    for (const FixItHint &hint : info.getFixItHints()) {
+      if (hint.RemoveRange.isInvalid()) {
+        continue;
+      }
+      SourceLocation begin =
+          sourceManager.getFileLoc(hint.RemoveRange.getBegin());
+      SourceLocation end = sourceManager.getFileLoc(hint.RemoveRange.getEnd());
+      if (hint.RemoveRange.isTokenRange()) {
+        end = Lexer::getLocForEndOfToken(end, 0, sourceManager, langOptions);
+      }
+      std::pair<FileID, unsigned> beginOffset =
+          sourceManager.getDecomposedLoc(begin);
+      std::pair<FileID, unsigned> endOffset =
+          sourceManager.getDecomposedLoc(end);
+      if (beginOffset.first != mainFile || endOffset.first != mainFile ||
+          endOffset.second < beginOffset.second) {
+        continue;
+      }
+
+      FindingFixIt fixIt;
+      fixIt.offset = beginOffset.second;
+      fixIt.length = endOffset.second - beginOffset.second;
+      fixIt.replacement = hint.CodeToInsert;
+      finding.fixIts.push_back(std::move(fixIt));
+    }
+  }
+
+  findings.push_back(std::move(finding));
+}
+
+bool hasProblems(const std::vector<Finding> &findings) {
+  for (const auto &finding : findings) {
+    if (finding.level >= DiagnosticsEngine::Warning) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void writeString(llvm::raw_ostream &os, StringRef str) {
+  os << str.size() << ':' << str << '\n';
+}
+
+bool readString(StringRef &data, std::string &str) {
+  size_t length;
+  if (data.consumeInteger(10, length) || !data.consume_front(":") ||
+      data.size() < length + 1 || data[length] != '\n') {
+    return false;
+  }
+  str = data.take_front(length).str();
+  data = data.drop_front(length + 1);
+  return true;
+}
+
+namespace {
+
+bool readNumber(StringRef &data, unsigned &value, char separator) {
+  return !data.consumeInteger(10, value) &&
+         data.consume_front(StringRef(&separator, 1));
+}
+
+} // namespace
+
+void writeFindings(llvm::raw_ostream &os,
+                   const std::vector<Finding> &findings) {
+  os << findings.size() << '\n';
+  for (const auto &finding : findings) {
+    os << static_cast<unsigned>(finding.level) << ' ' << finding.line << ' '
+       << finding.column << ' ' << finding.offset << ' '
+       << finding.fixIts.size() << '\n';
+    writeString(os, finding.checker);
+    writeString(os, finding.file);
+    writeString(os, finding.message);
+    for (const auto &fixIt : finding.fixIts) {
+      os << fixIt.offset << ' ' << fixIt.length << '\n';
+      writeString(os, fixIt.replacement);
+    }
+  }
+}
+
+bool readFindings(StringRef &data, std::vector<Finding> &findings) {
+  unsigned count;
+  if (!readNumber(data, count, '\n')) {
+    return false;
+  }
+  for (unsigned i = 0; i < count; ++i) {
+    Finding finding;
+    unsigned level, fixItCount;
+    if (!readNumber(data, level, ' ') ||
+        !readNumber(data, finding.line, ' ') ||
+        !readNumber(data, finding.column, ' ') ||
+        !readNumber(data, finding.offset, ' ') ||
+        !readNumber(data, fixItCount, '\n') ||
+        !readString(data, finding.checker) ||
+        !readString(data, finding.file) ||
+        !readString(data, finding.message)) {
+      return false;
+    }
+    finding.level = static_cast<DiagnosticsEngine::Level>(level);
+    for (unsigned j = 0; j < fixItCount; ++j) {
+      FindingFixIt fixIt;
+      if (!readNumber(data, fixIt.offset, ' ') ||
+          !readNumber(data, fixIt.length, '\n') ||
+          !readString(data, fixIt.replacement)) {
+        return false;
+      }
+      finding.fixIts.push_back(std::move(fixIt));
+    }
+    findings.push_back(std::move(finding));
+  }
+  return true;
+}
+
+} // namespace complint
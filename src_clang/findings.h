@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------
+// Diagnostics of a lint run as plain data.
+//
+// FindingCollector records every diagnostic reported while a file is linted,
+// so the results can be cached and replayed after the compiler state is gone.
+//------------------------------------------------------------------------------
+#ifndef COMPETITIVE_LINT_FINDINGS_H
+#define COMPETITIVE_LINT_FINDINGS_H
+
+#include <string>
+#include <vector>
+
+#include "clang/Basic/Diagnostic.h"
+#include "clang/Basic/LangOptions.h"
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "checker.h"
+
+namespace complint {
+
+// Replacement of a byte range of the main file.
+struct FindingFixIt {
+  unsigned offset = 0;
+  unsigned length = 0;
+  std::string replacement;
+};
+
+struct Finding {
+  clang::DiagnosticsEngine::Level level = clang::DiagnosticsEngine::Error;
+  // Name of the checker which reported it, empty for compiler diagnostics.
+  std::string checker;
+  // Empty for the main file, so findings don't depend on its path.
+  std::string file;
+  unsigned line = 0;
+  unsigned column = 0;
+  unsigned offset = 0;
+  std::string message;
+  std::vector<FindingFixIt> fixIts;
+};
+
+// Records all diagnostics and forwards them to another consumer, usually the
+// one printing them. Only the fix-its which edit the main file are kept. The
+// checker of a diagnostic is looked up in the registry, if one is set.
+class FindingCollector : public clang::DiagnosticConsumer {
+public:
+  explicit FindingCollector(clang::DiagnosticConsumer *next = nullptr)
+      : next(next) {}
+
+  void BeginSourceFile(const clang::LangOptions &langOptions,
+                       const clang::Preprocessor *PP) override;
+  void EndSourceFile() override;
+  void finish() override;
+  void HandleDiagnostic(clang::DiagnosticsEngine::Level level,
+                        const clang::Diagnostic &info) override;
+
+  void setRegistry(const DiagnosticRegistry *registry) {
+    this->registry = registry;
+  }
+
+  const std::vector<Finding> &getFindings() const { return findings; }
+
+protected:
+  clang::DiagnosticConsumer *next;
+  const DiagnosticRegistry *registry = nullptr;
+  clang::LangOptions langOptions;
+  std::vector<Finding> findings;
+};
+
+// True if any finding is a warning or an error.
+bool hasProblems(const std::vector<Finding> &findings);
+
+// Compact serialization used by the result cache.
+void writeFindings(llvm::raw_ostream &os, const std::vector<Finding> &findings);
+bool readFindings(llvm::StringRef &data, std::vector<Finding> &findings);
+
+// Length-prefixed strings, the building block of the serialization.
+void writeString(llvm::raw_ostream &os, llvm::StringRef str);
+bool readString(llvm::StringRef &data, std::string &str);
+
+} // namespace complint
+
+#endif // COMPETITIVE_LINT_FINDINGS_H
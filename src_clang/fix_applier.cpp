@@ -0,0 +1,264 @@
+//------------------------------------------------------------------------------
+// Overlap resolution, rewriting and diffs of the fix-its of a file.
+//------------------------------------------------------------------------------
+#include "fix_applier.h"
+
+#include <algorithm>
+
+#include "clang/Basic/Diagnostic.h"
+#include "clang/Basic/DiagnosticOptions.h"
+#include "clang/Basic/FileManager.h"
+#include "clang/Basic/LangOptions.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Rewrite/Core/Rewriter.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "source_scan.h"
+
+namespace complint {
+
+using namespace clang;
+
+namespace {
+
+// Lines of context around the changes of a diff hunk.
+constexpr unsigned DIFF_CONTEXT = 3;
+
+// Whether two fix-its can't be applied together. Two insertions only
+// conflict at the same offset, as their order would be arbitrary.
+bool overlap(const FindingFixIt &a, const FindingFixIt &b) {
+  unsigned aEnd = a.offset + a.length;
+  unsigned bEnd = b.offset + b.length;
+  if (a.length == 0 && b.length == 0) {
+    return a.offset == b.offset;
+  }
+  if (a.length == 0) {
+    return b.offset < a.offset && a.offset < bEnd;
+  }
+  if (b.length == 0) {
+    return a.offset < b.offset && b.offset < aEnd;
+  }
+  return a.offset < bEnd && b.offset < aEnd;
+}
+
+// The fix-its of the findings which can be applied together, in the order of
+// the findings. A finding is kept if none of its fix-its overlaps those of a
+// kept one; its own fix-its, e.g. two insertions at the same offset, are
+// applied in their order.
+std::vector<FindingFixIt> selectFixIts(const std::vector<Finding> &findings,
+                                       StringRef source, FixResult &result) {
+  std::vector<FindingFixIt> selected;
+  for (const Finding &finding : findings) {
+    if (finding.checker.empty() || !finding.file.empty() ||
+        finding.fixIts.empty()) {
+      continue;
+    }
+    bool valid = true;
+    for (const FindingFixIt &fixIt : finding.fixIts) {
+      valid = valid && fixIt.offset <= source.size() &&
+              fixIt.length <= source.size() - fixIt.offset;
+      for (const FindingFixIt &other : selected) {
+        valid = valid && !overlap(fixIt, other);
+      }
+    }
+    if (!valid) {
+      ++result.skipped;
+      continue;
+    }
+    selected.insert(selected.end(), finding.fixIts.begin(),
+                    finding.fixIts.end());
+    ++result.applied;
+  }
+  // Stable, so the insertions at one offset stay in order.
+  std::stable_sort(selected.begin(), selected.end(),
+                   [](const FindingFixIt &a, const FindingFixIt &b) {
+                     return a.offset < b.offset;
+                   });
+  return selected;
+}
+
+// The lines of text, with their line breaks.
+std::vector<StringRef> splitLines(StringRef text) {
+  std::vector<StringRef> lines;
+  while (!text.empty()) {
+    size_t end = std::min(text.find('\n'), text.size() - 1) + 1;
+    lines.push_back(text.substr(0, end));
+    text = text.substr(end);
+  }
+  return lines;
+}
+
+// Prints lines with prefix, marking a missing final line break the way diff
+// does.
+void writeDiffLines(llvm::raw_ostream &os, char prefix,
+                    ArrayRef<StringRef> lines) {
+  for (StringRef line : lines) {
+    os << prefix << line;
+    if (!line.endswith("\n")) {
+      os << "\n\\ No newline at end of file\n";
+    }
+  }
+}
+
+// One hunk of the diff: the lines [firstLine, lastLine] of the old buffer.
+struct Hunk {
+  unsigned firstLine;
+  unsigned lastLine;
+};
+
+void writeDiff(llvm::raw_ostream &os, StringRef path, StringRef source,
+               const std::vector<FindingFixIt> &fixIts,
+               const Rewriter &rewriter, SourceLocation fileStart) {
+  SourceScan scan(source);
+  std::vector<Hunk> hunks;
+  for (const FindingFixIt &fixIt : fixIts) {
+    unsigned first = scan.getLineOf(fixIt.offset);
+    unsigned last =
+        scan.getLineOf(fixIt.offset + std::max(fixIt.length, 1u) - 1);
+    unsigned begin = first > DIFF_CONTEXT ? first - DIFF_CONTEXT : 0;
+    unsigned end = std::min(last + DIFF_CONTEXT, scan.getLineCount() - 1);
+    if (!hunks.empty() && begin <= hunks.back().lastLine + 1) {
+      hunks.back().lastLine = std::max(hunks.back().lastLine, end);
+    } else {
+      hunks.push_back({begin, end});
+    }
+  }
+
+  os << "--- " << path << "\n+++ " << path << "\n";
+  int lineDelta = 0;
+  for (const Hunk &hunk : hunks) {
+    unsigned begin = scan.getLineStart(hunk.firstLine);
+    unsigned end = scan.isTerminated(hunk.lastLine)
+                       ? scan.getLineStart(hunk.lastLine + 1)
+                       : source.size();
+    StringRef oldText = source.slice(begin, end);
+    std::string newText =
+        rewriter.getRewrittenText(CharSourceRange::getCharRange(
+            fileStart.getLocWithOffset(begin),
+            fileStart.getLocWithOffset(end)));
+
+    // The unchanged lines at both ends are context.
+    std::vector<StringRef> oldLines = splitLines(oldText);
+    std::vector<StringRef> newLines = splitLines(newText);
+    size_t prefix = 0;
+    while (prefix < oldLines.size() && prefix < newLines.size() &&
+           oldLines[prefix] == newLines[prefix]) {
+      ++prefix;
+    }
+    size_t suffix = 0;
+    while (prefix + suffix < oldLines.size() &&
+           prefix + suffix < newLines.size() &&
+           oldLines[oldLines.size() - 1 - suffix] ==
+               newLines[newLines.size() - 1 - suffix]) {
+      ++suffix;
+    }
+
+    unsigned oldCount = oldLines.size();
+    unsigned newCount = newLines.size();
+    unsigned oldStart = hunk.firstLine + 1;
+    unsigned newStart = oldStart + lineDelta;
+    os << "@@ -" << (oldCount ? oldStart : oldStart - 1) << ',' << oldCount
+       << " +" << (newCount ? newStart : newStart - 1) << ',' << newCount
+       << " @@\n";
+    ArrayRef<StringRef> oldRef(oldLines), newRef(newLines);
+    writeDiffLines(os, ' ', oldRef.take_front(prefix));
+    writeDiffLines(os, '-',
+                   oldRef.drop_front(prefix).drop_back(suffix));
+    writeDiffLines(os, '+',
+                   newRef.drop_front(prefix).drop_back(suffix));
+    writeDiffLines(os, ' ', oldRef.take_back(suffix));
+    lineDelta += int(newCount) - int(oldCount);
+  }
+}
+
+} // namespace
+
+FixResult fixFile(StringRef path, StringRef source,
+                  const std::vector<Finding> &findings, FixMode mode) {
+  FixResult result;
+  std::vector<FindingFixIt> fixIts = selectFixIts(findings, source, result);
+  if (fixIts.empty()) {
+    return result;
+  }
+
+  IntrusiveRefCntPtr<DiagnosticIDs> diagnosticIDs(new DiagnosticIDs());
+  IntrusiveRefCntPtr<DiagnosticOptions> diagnosticOptions(
+      new DiagnosticOptions());
+  IgnoringDiagConsumer ignoring;
+  DiagnosticsEngine diagnostics(diagnosticIDs, diagnosticOptions.get(),
+                                &ignoring, /*ShouldOwnClient=*/false);
+  FileManager fileManager((FileSystemOptions()));
+  SourceManager sourceManager(diagnostics, fileManager);
+  FileID file = sourceManager.createFileID(
+      llvm::MemoryBuffer::getMemBuffer(source, path,
+                                       /*RequiresNullTerminator=*/false));
+  SourceLocation fileStart = sourceManager.getLocForStartOfFile(file);
+
+  LangOptions langOptions;
+  langOptions.CPlusPlus = true;
+  Rewriter rewriter(sourceManager, langOptions);
+  for (const FindingFixIt &fixIt : fixIts) {
+    rewriter.ReplaceText(fileStart.getLocWithOffset(fixIt.offset),
+                         fixIt.length, fixIt.replacement);
+  }
+
+  if (mode == FixMode::Diff) {
+    llvm::raw_string_ostream os(result.diff);
+    writeDiff(os, path, source, fixIts, rewriter, fileStart);
+    os.flush();
+    return result;
+  }
+
+  const RewriteBuffer *buffer = rewriter.getRewriteBufferFor(file);
+  std::string contents(buffer->begin(), buffer->end());
+  if (!writeFileAtomically(path, contents, result.error)) {
+    result.applied = 0;
+  }
+  return result;
+}
+
+bool writeFileAtomically(StringRef path, StringRef contents,
+                         std::string &error) {
+  int fd;
+  SmallString<128> tempPath;
+  if (std::error_code code = llvm::sys::fs::createUniqueFile(
+          path + "-%%%%%%.tmp", fd, tempPath)) {
+    error = path.str() + ": " + code.message();
+    return false;
+  }
+  {
+    llvm::raw_fd_ostream file(fd, /*shouldClose=*/true);
+    file << contents;
+    file.close();
+    if (file.has_error()) {
+      file.clear_error();
+      llvm::sys::fs::remove(tempPath);
+      error = path.str() + ": write failed";
+      return false;
+    }
+  }
+  // The temporary file was created with the default mode, which would
+  // replace the one of the file.
+  llvm::sys::fs::file_status status;
+  if (!llvm::sys::fs::status(path, status)) {
+    if (std::error_code code =
+            llvm::sys::fs::setPermissions(tempPath, status.permissions())) {
+      llvm::sys::fs::remove(tempPath);
+      error = path.str() + ": " + code.message();
+      return false;
+    }
+  }
+  if (std::error_code code = llvm::sys::fs::rename(tempPath, path)) {
+    llvm::sys::fs::remove(tempPath);
+    error = path.str() + ": " + code.message();
+    return false;
+  }
+  return true;
+}
+
+} // namespace complint
@@ -0,0 +1,55 @@
+//------------------------------------------------------------------------------
+// Batch application of the fix-its of the checkers.
+//
+// Applying the fix-its of no_float and floating_point_comp used to take
+// another clang run with -fixit for every file. The findings already carry
+// their fix-its as byte ranges of the main file (see findings.h), cached
+// with the results, so comp-lint -fix applies them straight after linting,
+// with a Rewriter over the buffer which was linted:
+//
+// - The fix-its of one finding are applied together or not at all. If they
+//   overlap an earlier finding's, the later finding is skipped; a second run
+//   picks it up.
+// - Files are written to a temporary file next to them and renamed into
+//   place, so a crash never leaves half a file behind. The file keeps its
+//   permissions.
+// - With -fix-diff nothing is written, and a unified diff is printed instead.
+//
+// Only the fix-its of the checkers are applied, not those of the compiler.
+//------------------------------------------------------------------------------
+#ifndef COMPETITIVE_LINT_FIX_APPLIER_H
+#define COMPETITIVE_LINT_FIX_APPLIER_H
+
+#include <string>
+#include <vector>
+
+#include "llvm/ADT/StringRef.h"
+
+#include "findings.h"
+
+namespace complint {
+
+enum class FixMode { Apply, Diff };
+
+struct FixResult {
+  // Findings whose fix-its were applied, and those skipped for overlapping.
+  unsigned applied = 0;
+  unsigned skipped = 0;
+  // The unified diff, in Diff mode.
+  std::string diff;
+  // Set if the file couldn't be written.
+  std::string error;
+};
+
+// Applies the fix-its of findings to source, the buffer of the file at path
+// which was linted.
+FixResult fixFile(llvm::StringRef path, llvm::StringRef source,
+                  const std::vector<Finding> &findings, FixMode mode);
+
+// Replaces the file at path with contents through a rename.
+bool writeFileAtomically(llvm::StringRef path, llvm::StringRef contents,
+                         std::string &error);
+
+} // namespace complint
+
+#endif // COMPETITIVE_LINT_FIX_APPLIER_H
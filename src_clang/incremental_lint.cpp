@@ -0,0 +1,229 @@
+//------------------------------------------------------------------------------
+// Edit detection and reuse of findings for the incremental mode.
+//------------------------------------------------------------------------------
+#include "incremental_lint.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace complint {
+
+using namespace llvm;
+
+namespace {
+
+bool isSpace(char c) { return std::isspace(static_cast<unsigned char>(c)); }
+
+// The comment containing offset, or null.
+const CommentSpan *findComment(const SourceScan &scan, unsigned offset) {
+  const auto &comments = scan.getComments();
+  auto it = std::upper_bound(
+      comments.begin(), comments.end(), offset,
+      [](unsigned offset, const CommentSpan &comment) {
+        return offset < comment.begin;
+      });
+  if (it == comments.begin()) {
+    return nullptr;
+  }
+  --it;
+  return offset < it->end ? &*it : nullptr;
+}
+
+bool isTrivia(const SourceScan &scan, unsigned offset) {
+  return isSpace(scan.getSource()[offset]) || findComment(scan, offset);
+}
+
+// Whether [begin, end) consists of whitespace and comments only.
+bool isTriviaRange(const SourceScan &scan, unsigned begin, unsigned end) {
+  for (unsigned offset = begin; offset < end; ++offset) {
+    if (isSpace(scan.getSource()[offset])) {
+      continue;
+    }
+    const CommentSpan *comment = findComment(scan, offset);
+    if (!comment) {
+      return false;
+    }
+    offset = comment->end - 1;
+  }
+  return true;
+}
+
+// Whether the lines around [begin, end] are free of what makes whitespace
+// significant: preprocessor directives, line continuations and literals.
+bool areLinesPlain(const SourceScan &scan, unsigned begin, unsigned end) {
+  unsigned first = scan.getLineOf(begin);
+  unsigned last = scan.getLineOf(end);
+  // A continued directive starts on an earlier line.
+  if (first > 0) {
+    --first;
+  }
+  for (unsigned line = first; line <= last; ++line) {
+    StringRef text = scan.getLine(line).rtrim("\r");
+    if (text.ltrim().startswith("#") || text.endswith("\\") ||
+        text.find_first_of("\"'") != StringRef::npos) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The comments of the unchanged tail must stay the same, or the edit turned
+// code into comment text or the other way round.
+bool haveSameTailComments(const SourceScan &oldScan,
+                          const SourceScan &newScan, const Edit &edit) {
+  std::vector<CommentSpan> oldTail, newTail;
+  for (const CommentSpan &comment : oldScan.getComments()) {
+    if (comment.end > edit.oldEnd) {
+      oldTail.push_back(comment);
+    }
+  }
+  for (const CommentSpan &comment : newScan.getComments()) {
+    if (comment.end > edit.newEnd) {
+      newTail.push_back(comment);
+    }
+  }
+  if (oldTail.size() != newTail.size()) {
+    return false;
+  }
+  int delta = int(edit.newEnd) - int(edit.oldEnd);
+  for (size_t i = 0; i < oldTail.size(); ++i) {
+    if (oldTail[i].end + delta != newTail[i].end ||
+        oldTail[i].isLineComment != newTail[i].isLineComment) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Whether one of the lines of [begin, end] is, or continues, a preprocessor
+// directive.
+bool hasDirective(const SourceScan &scan, unsigned begin, unsigned end) {
+  unsigned first = scan.getLineOf(begin);
+  unsigned last = scan.getLineOf(end);
+  while (first > 0 && scan.getLine(first - 1).rtrim("\r").endswith("\\")) {
+    --first;
+  }
+  for (unsigned line = first; line <= last; ++line) {
+    if (scan.getLine(line).ltrim().startswith("#")) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+Edit findEdit(StringRef oldSource, StringRef newSource) {
+  size_t limit = std::min(oldSource.size(), newSource.size());
+  size_t prefix = 0;
+  while (prefix < limit && oldSource[prefix] == newSource[prefix]) {
+    ++prefix;
+  }
+  size_t suffix = 0;
+  while (suffix < limit - prefix &&
+         oldSource[oldSource.size() - 1 - suffix] ==
+             newSource[newSource.size() - 1 - suffix]) {
+    ++suffix;
+  }
+
+  Edit edit;
+  edit.begin = prefix;
+  edit.oldEnd = oldSource.size() - suffix;
+  edit.newEnd = newSource.size() - suffix;
+  return edit;
+}
+
+bool isTriviaEdit(const SourceScan &oldScan, const SourceScan &newScan,
+                  const Edit &edit) {
+  StringRef newSource = newScan.getSource();
+  // Moving lines changes what these expand to.
+  if (newSource.find("__LINE__") != StringRef::npos ||
+      newSource.find("R\"") != StringRef::npos) {
+    return false;
+  }
+  if (!isTriviaRange(oldScan, edit.begin, edit.oldEnd) ||
+      !isTriviaRange(newScan, edit.begin, edit.newEnd) ||
+      !areLinesPlain(oldScan, edit.begin, edit.oldEnd) ||
+      !areLinesPlain(newScan, edit.begin, edit.newEnd) ||
+      !haveSameTailComments(oldScan, newScan, edit)) {
+    return false;
+  }
+
+  // Trivia on both sides keeps the tokens apart as before. Otherwise the
+  // edit must be next to other trivia, or it may join "a b" into "ab" or
+  // split "ab" into "a b".
+  if (edit.begin != edit.oldEnd && edit.begin != edit.newEnd) {
+    return true;
+  }
+  return edit.begin == 0 || edit.newEnd == newSource.size() ||
+         isTrivia(newScan, edit.begin - 1) || isTrivia(newScan, edit.newEnd);
+}
+
+bool editsDirective(const SourceScan &oldScan, const SourceScan &newScan,
+                    const Edit &edit) {
+  return hasDirective(oldScan, edit.begin, edit.oldEnd) ||
+         hasDirective(newScan, edit.begin, edit.newEnd);
+}
+
+bool shiftFinding(Finding &finding, const Edit &edit,
+                  const SourceScan &newScan) {
+  // Diagnostics in headers and without a location don't move.
+  if (!finding.file.empty() || finding.line == 0 || edit.isEmpty()) {
+    return true;
+  }
+
+  int delta = int(edit.newEnd) - int(edit.oldEnd);
+  auto shift = [&](unsigned &offset) {
+    if (offset >= edit.oldEnd) {
+      offset += delta;
+    }
+  };
+  if (finding.offset >= edit.begin && finding.offset < edit.oldEnd) {
+    return false;
+  }
+  for (const FindingFixIt &fixIt : finding.fixIts) {
+    if (fixIt.offset < edit.oldEnd && fixIt.offset + fixIt.length > edit.begin) {
+      return false;
+    }
+  }
+
+  shift(finding.offset);
+  for (FindingFixIt &fixIt : finding.fixIts) {
+    shift(fixIt.offset);
+  }
+  unsigned line = newScan.getLineOf(finding.offset);
+  finding.line = line + 1;
+  finding.column = finding.offset - newScan.getLineStart(line) + 1;
+  return true;
+}
+
+void reuseFindings(const std::vector<Finding> &oldFindings, const Edit &edit,
+                   const TraversalLimit &limit, const SourceScan &newScan,
+                   std::vector<Finding> &findings) {
+  // All findings were reported again.
+  if (limit.traversedAll) {
+    return;
+  }
+  for (Finding finding : oldFindings) {
+    // Compiler diagnostics come from the new parse, as do all findings of
+    // the program-wide checkers.
+    if (finding.checker.empty() || !finding.file.empty() ||
+        std::find(limit.programWideCheckers.begin(),
+                  limit.programWideCheckers.end(),
+                  finding.checker) != limit.programWideCheckers.end() ||
+        !shiftFinding(finding, edit, newScan)) {
+      continue;
+    }
+    bool traversed = std::any_of(
+        limit.traversedRanges.begin(), limit.traversedRanges.end(),
+        [&](const std::pair<unsigned, unsigned> &range) {
+          return finding.offset >= range.first &&
+                 finding.offset <= range.second;
+        });
+    if (!traversed) {
+      findings.push_back(std::move(finding));
+    }
+  }
+}
+
+} // namespace complint
@@ -0,0 +1,90 @@
+//------------------------------------------------------------------------------
+// Incremental re-linting of a buffer which is edited between runs.
+//
+// In an editor the same file is linted after every small edit. A LintSession
+// keeps the previous buffer and the findings of its AST run, and the next run
+// only redoes what the edit can have changed:
+//
+// - The text and comment checks always run on the whole new buffer. The
+//   scan is a single pass which takes microseconds for thousands of lines.
+// - If the edit only touches whitespace and comments (see isTriviaEdit), the
+//   token stream is the same, so nothing is parsed: the previous AST findings
+//   are moved to their new positions.
+// - Otherwise the buffer is parsed. If the edit lies within the body of a
+//   single function, and doesn't touch a preprocessor directive, only the
+//   top-level declarations which overlap it are traversed. The findings of
+//   the checkers in all other declarations are taken from the previous run,
+//   except for the checkers which walk the program from main (see
+//   Checker::isProgramWide), whose findings are all reported again.
+// - Any other edit, e.g. of a typedef or a constant, can change how the rest
+//   of the file is typed or evaluated, so the whole buffer is traversed.
+// - An edit which a checker declares global (see Checker::isGlobalEdit), e.g.
+//   adding a marker comment, relints the whole buffer.
+//
+// The include prologue comes from the PCH cache, so parsing costs little more
+// than the main file itself.
+//------------------------------------------------------------------------------
+#ifndef COMPETITIVE_LINT_INCREMENTAL_LINT_H
+#define COMPETITIVE_LINT_INCREMENTAL_LINT_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "llvm/ADT/StringRef.h"
+
+#include "findings.h"
+#include "main_file_traversal.h"
+#include "source_scan.h"
+
+namespace complint {
+
+class LintSession {
+public:
+  // One run at a time; the next one starts from the state of the last.
+  std::mutex mutex;
+
+  // False until the first run.
+  bool valid = false;
+  std::string source;
+  // Findings of the AST run: compiler diagnostics and AST checkers.
+  std::vector<Finding> astFindings;
+};
+
+// The single byte range in which two versions of a buffer differ:
+// [begin, oldEnd) of the old version was replaced by [begin, newEnd).
+struct Edit {
+  unsigned begin = 0;
+  unsigned oldEnd = 0;
+  unsigned newEnd = 0;
+
+  bool isEmpty() const { return begin == oldEnd && begin == newEnd; }
+};
+
+Edit findEdit(llvm::StringRef oldSource, llvm::StringRef newSource);
+
+// Whether the edit can't change the tokens of the buffer: it only replaces
+// whitespace or comment text, outside of preprocessor directives and
+// literals, without joining or splitting tokens.
+bool isTriviaEdit(const SourceScan &oldScan, const SourceScan &newScan,
+                  const Edit &edit);
+
+// Whether the edit touches a preprocessor directive in either version, e.g.
+// a #define, which can change how everything after it is parsed.
+bool editsDirective(const SourceScan &oldScan, const SourceScan &newScan,
+                    const Edit &edit);
+
+// Moves finding of the old version to its place in the new one. Returns false
+// if it is in the edited range.
+bool shiftFinding(Finding &finding, const Edit &edit,
+                  const SourceScan &newScan);
+
+// Adds the checker findings of the old AST run which are outside of the
+// edit and of the traversed declarations of limit, moved to their new place.
+void reuseFindings(const std::vector<Finding> &oldFindings, const Edit &edit,
+                   const TraversalLimit &limit, const SourceScan &newScan,
+                   std::vector<Finding> &findings);
+
+} // namespace complint
+
+#endif // COMPETITIVE_LINT_INCREMENTAL_LINT_H
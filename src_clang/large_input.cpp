@@ -0,0 +1,264 @@
+//------------------------------------------------------------------------------
+// Elision of constant tables and the memory budget of the workers.
+//------------------------------------------------------------------------------
+#include "large_input.h"
+
+#include <cctype>
+
+namespace complint {
+
+using namespace llvm;
+
+namespace {
+
+// Memory of the headers (mostly loaded lazily from the PCH) and of the
+// compiler itself, and per byte of the main file. Measured on dense
+// competitive programming code, rounded up.
+constexpr uint64_t BASE_MEMORY = 128 << 20;
+constexpr uint64_t MEMORY_PER_BYTE = 64;
+
+bool isIdentifierChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool isSpace(char c) { return std::isspace(static_cast<unsigned char>(c)); }
+
+char at(StringRef source, size_t pos) {
+  return pos < source.size() ? source[pos] : 0;
+}
+
+// End of the comment starting at pos, or npos if it isn't terminated.
+size_t skipComment(StringRef source, size_t pos) {
+  if (source[pos + 1] == '/') {
+    size_t end = source.find('\n', pos);
+    return end == StringRef::npos ? source.size() : end;
+  }
+  size_t end = source.find("*/", pos + 2);
+  return end == StringRef::npos ? StringRef::npos : end + 2;
+}
+
+// End of the string or character literal whose quote is at pos, or npos if
+// it isn't terminated on its line.
+size_t skipQuoted(StringRef source, size_t pos) {
+  char quote = source[pos];
+  for (size_t i = pos + 1; i < source.size(); ++i) {
+    if (source[i] == '\\') {
+      ++i;
+    } else if (source[i] == quote) {
+      return i + 1;
+    } else if (source[i] == '\n') {
+      return StringRef::npos;
+    }
+  }
+  return StringRef::npos;
+}
+
+// End of the raw string literal whose quote is at pos.
+size_t skipRawString(StringRef source, size_t pos) {
+  size_t open = source.find('(', pos + 1);
+  if (open == StringRef::npos) {
+    return StringRef::npos;
+  }
+  std::string terminator = ")" + source.slice(pos + 1, open).str() + "\"";
+  size_t close = source.find(terminator, open + 1);
+  return close == StringRef::npos ? StringRef::npos
+                                  : close + terminator.size();
+}
+
+// End of the pp-number starting at pos, e.g. 1e-9, 0x1F or 1'000'000ULL.
+size_t skipNumber(StringRef source, size_t pos) {
+  size_t i = pos;
+  while (i < source.size()) {
+    char c = source[i];
+    if ((c == '+' || c == '-') &&
+        (std::tolower(static_cast<unsigned char>(source[i - 1])) == 'e' ||
+         std::tolower(static_cast<unsigned char>(source[i - 1])) == 'p')) {
+      ++i;
+    } else if (isIdentifierChar(c) || c == '.' ||
+               (c == '\'' && isIdentifierChar(at(source, i + 1)))) {
+      ++i;
+    } else {
+      break;
+    }
+  }
+  return i;
+}
+
+// End of the token at pos if it can appear in a table of constants without
+// any checker caring: a literal, a comment, a sign, a comma or whitespace.
+// Identifiers are rejected, as they may be macros expanding to anything.
+size_t skipConstantToken(StringRef source, size_t pos) {
+  char c = source[pos];
+  if (isSpace(c) || c == ',' || c == '+' || c == '-') {
+    return pos + 1;
+  }
+  if (std::isdigit(static_cast<unsigned char>(c)) ||
+      (c == '.' && std::isdigit(static_cast<unsigned char>(at(source,
+                                                               pos + 1))))) {
+    return skipNumber(source, pos);
+  }
+  if (c == '"' || c == '\'') {
+    return skipQuoted(source, pos);
+  }
+  if (c == '/' && (at(source, pos + 1) == '/' || at(source, pos + 1) == '*')) {
+    return skipComment(source, pos);
+  }
+  // Encoding prefixes of literals, but not of raw strings.
+  for (StringRef prefix : {"u8", "u", "U", "L"}) {
+    if (source.substr(pos).startswith(prefix)) {
+      char next = at(source, pos + prefix.size());
+      if (next == '"' || next == '\'') {
+        return skipQuoted(source, pos + prefix.size());
+      }
+    }
+  }
+  return StringRef::npos;
+}
+
+// If the braced list opening at pos only contains constants, returns the
+// position of its closing brace and sets firstComma to the end of its first
+// element, or to npos if it has only one.
+size_t matchConstantList(StringRef source, size_t pos, size_t &firstComma) {
+  firstComma = StringRef::npos;
+  unsigned depth = 0;
+  size_t i = pos;
+  while (i < source.size()) {
+    char c = source[i];
+    if (c == '{') {
+      ++depth;
+      ++i;
+    } else if (c == '}') {
+      if (--depth == 0) {
+        return i;
+      }
+      ++i;
+    } else {
+      if (c == ',' && depth == 1 && firstComma == StringRef::npos) {
+        firstComma = i;
+      }
+      i = skipConstantToken(source, i);
+      if (i == StringRef::npos) {
+        return StringRef::npos;
+      }
+    }
+  }
+  return StringRef::npos;
+}
+
+// Replaces [begin, end) with spaces, keeping the line breaks. Returns the
+// number of bytes replaced.
+size_t blank(std::string &text, size_t begin, size_t end) {
+  size_t count = 0;
+  for (size_t i = begin; i < end; ++i) {
+    if (text[i] != '\n' && text[i] != '\r') {
+      text[i] = ' ';
+      ++count;
+    }
+  }
+  return count;
+}
+
+} // namespace
+
+size_t elideLargeInitializers(StringRef source, size_t threshold,
+                              std::string &elided) {
+  elided.clear();
+  // Nothing can be large enough.
+  if (source.size() < threshold) {
+    return 0;
+  }
+
+  // Whether the declaration being scanned has an array without a bound,
+  // whose size depends on its initializer. Cleared at the end of the
+  // statement; a lambda introducer [] sets it as well, which only means
+  // that less is elided.
+  bool unboundedArray = false;
+  size_t blanked = 0;
+  size_t i = 0;
+  while (i < source.size()) {
+    char c = source[i];
+    size_t end = i + 1;
+    if (c == ';') {
+      unboundedArray = false;
+    } else if (c == '[') {
+      size_t next = i + 1;
+      while (next < source.size() && isSpace(source[next])) {
+        ++next;
+      }
+      if (at(source, next) == ']') {
+        unboundedArray = true;
+      }
+    } else if (c == '/' &&
+               (at(source, i + 1) == '/' || at(source, i + 1) == '*')) {
+      end = skipComment(source, i);
+    } else if (isIdentifierChar(c)) {
+      end = i;
+      while (end < source.size() && isIdentifierChar(source[end])) {
+        ++end;
+      }
+      // A number may continue with a digit separator, a raw string prefix
+      // with the string.
+      if (std::isdigit(static_cast<unsigned char>(c))) {
+        end = skipNumber(source, i);
+      } else if (at(source, end) == '"' &&
+                 source.slice(i, end).endswith("R")) {
+        end = skipRawString(source, end);
+      }
+    } else if (c == '\'') {
+      end = skipQuoted(source, i);
+    } else if (c == '"') {
+      end = skipQuoted(source, i);
+      if (end != StringRef::npos && end - i >= threshold && !unboundedArray) {
+        if (elided.empty()) {
+          elided = source.str();
+        }
+        elided[i + 1] = '"';
+        blanked += 1 + blank(elided, i + 2, end);
+      }
+    } else if (c == '{') {
+      size_t firstComma;
+      size_t close = unboundedArray
+                         ? StringRef::npos
+                         : matchConstantList(source, i, firstComma);
+      if (close != StringRef::npos && close - i >= threshold &&
+          firstComma != StringRef::npos) {
+        if (elided.empty()) {
+          elided = source.str();
+        }
+        blanked += blank(elided, firstComma, close);
+        end = close + 1;
+      }
+    }
+    // Unterminated literals and comments end the file as far as elision
+    // goes; the compiler reports them.
+    if (end == StringRef::npos) {
+      break;
+    }
+    i = end;
+  }
+  return blanked;
+}
+
+uint64_t estimateLintMemory(size_t sourceSize) {
+  return BASE_MEMORY + MEMORY_PER_BYTE * sourceSize;
+}
+
+bool MemoryBudget::acquire(uint64_t bytes) {
+  if (bytes > limit) {
+    return false;
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  released.wait(lock, [&] { return used + bytes <= limit; });
+  used += bytes;
+  return true;
+}
+
+void MemoryBudget::release(uint64_t bytes) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    used -= bytes;
+  }
+  released.notify_all();
+}
+
+} // namespace complint
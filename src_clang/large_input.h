@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+// Bounded memory for huge generated submissions.
+//
+// Some submissions embed precomputed tables of many megabytes as initializer
+// lists or string literals. Clang builds an AST node for every element, so a
+// 20 MB table costs gigabytes, although no checker looks at a list of
+// literals. On request (-elide-initializers), comp-lint therefore compiles a
+// copy of the buffer in which the large constant tables are blanked out:
+//
+//   int table[N] = {1, 2, 3, ..., 1000000};  ->  int table[N] = {1          };
+//   const char *s = "......";                ->  const char *s = ""      ;
+//
+// Only whitespace replaces the elided text and line breaks are kept, so every
+// offset, line and column stays the same and the findings need no mapping.
+// The text and comment checks still run on the original buffer.
+//
+// The size of an array comes from its initializer if it has no bound, e.g.
+// int t[] = {...} or char s[] = "...", so those are never elided: sizeof t
+// and the checks depending on it see the same program either way. The values
+// of the elided elements are lost, so constant expressions reading them
+// evaluate differently, which is why elision is off by default.
+//
+// The AST memory of a file is estimated from the size of the compiled buffer,
+// without the blanked out bytes, and the workers reserve it from a shared
+// MemoryBudget before compiling, so the jobs admitted together stay below the
+// configured amount by that estimate. It is an admission control, not a
+// limit: nothing stops a job which needs more than estimated. A file whose
+// estimate exceeds the whole budget gets the text checks only.
+//------------------------------------------------------------------------------
+#ifndef COMPETITIVE_LINT_LARGE_INPUT_H
+#define COMPETITIVE_LINT_LARGE_INPUT_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "llvm/ADT/StringRef.h"
+
+namespace complint {
+
+// Sets elided to source with the constant initializer lists and string
+// literals of at least threshold bytes blanked out, except those of arrays
+// without a bound. Returns the number of bytes blanked out, or 0, leaving
+// elided empty, if there are none.
+size_t elideLargeInitializers(llvm::StringRef source, size_t threshold,
+                            std::string &elided);
+
+// Rough upper bound of the memory taken by linting a buffer of sourceSize
+// bytes, not counting elided ones, headers included.
+uint64_t estimateLintMemory(size_t sourceSize);
+
+// Admits jobs by their estimated memory, up to limit bytes together.
+class MemoryBudget {
+public:
+  explicit MemoryBudget(uint64_t limit) : limit(limit) {}
+
+  // Waits until bytes are available and takes them. Returns false at once if
+  // bytes exceed the whole budget.
+  bool acquire(uint64_t bytes);
+  void release(uint64_t bytes);
+
+private:
+  uint64_t limit;
+  uint64_t used = 0;
+  std::mutex mutex;
+  std::condition_variable released;
+};
+
+// Holds bytes of a budget, if any, for its lifetime.
+class MemoryReservation {
+public:
+  MemoryReservation(MemoryBudget *budget, uint64_t bytes)
+      : budget(budget), bytes(bytes) {
+    acquired = !budget || budget->acquire(bytes);
+  }
+  ~MemoryReservation() {
+    if (budget && acquired) {
+      budget->release(bytes);
+    }
+  }
+  MemoryReservation(const MemoryReservation &) = delete;
+  MemoryReservation &operator=(const MemoryReservation &) = delete;
+
+  bool isAcquired() const { return acquired; }
+
+private:
+  MemoryBudget *budget;
+  uint64_t bytes;
+  bool acquired;
+};
+
+} // namespace complint
+
+#endif // COMPETITIVE_LINT_LARGE_INPUT_H
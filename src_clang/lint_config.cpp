@@ -0,0 +1,303 @@
+//------------------------------------------------------------------------------
+// Loading and application of the checker configuration.
+//------------------------------------------------------------------------------
+#include "lint_config.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/YAMLParser.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace complint {
+
+using namespace clang;
+using namespace llvm;
+
+namespace {
+
+bool parseBool(StringRef value, bool &result) {
+  std::string lower = value.lower();
+  if (lower == "true" || lower == "on" || lower == "yes" || lower == "1") {
+    result = true;
+    return true;
+  }
+  if (lower == "false" || lower == "off" || lower == "no" || lower == "0") {
+    result = false;
+    return true;
+  }
+  return false;
+}
+
+bool parseLevel(StringRef name, DiagnosticsEngine::Level &level) {
+  int value = StringSwitch<int>(name.lower())
+                  .Case("ignored", DiagnosticsEngine::Ignored)
+                  .Case("note", DiagnosticsEngine::Note)
+                  .Case("remark", DiagnosticsEngine::Remark)
+                  .Case("warning", DiagnosticsEngine::Warning)
+                  .Case("error", DiagnosticsEngine::Error)
+                  .Case("fatal", DiagnosticsEngine::Fatal)
+                  .Default(-1);
+  if (value < 0) {
+    return false;
+  }
+  level = static_cast<DiagnosticsEngine::Level>(value);
+  return true;
+}
+
+// The value of a scalar node, or false if node isn't one.
+bool getScalar(yaml::Node *node, std::string &value) {
+  auto *scalar = dyn_cast_or_null<yaml::ScalarNode>(node);
+  if (!scalar) {
+    return false;
+  }
+  SmallString<64> storage;
+  value = scalar->getValue(storage).str();
+  return true;
+}
+
+} // namespace
+
+bool LintConfig::loadFile(StringRef path, std::string &error) {
+  auto buffer = MemoryBuffer::getFile(path);
+  if (!buffer) {
+    error = path.str() + ": " + buffer.getError().message();
+    return false;
+  }
+  if (!parseYAML((*buffer)->getBuffer(), error)) {
+    error = path.str() + ": " + error;
+    return false;
+  }
+  return true;
+}
+
+bool LintConfig::parseYAML(StringRef text, std::string &error) {
+  SourceMgr sourceManager;
+  // The parser reports its errors through the SourceMgr.
+  sourceManager.setDiagHandler(
+      [](const SMDiagnostic &diagnostic, void *context) {
+        std::string &error = *static_cast<std::string *>(context);
+        if (error.empty()) {
+          raw_string_ostream os(error);
+          os << diagnostic.getLineNo() << ':' << diagnostic.getColumnNo() + 1
+             << ": " << diagnostic.getMessage();
+        }
+      },
+      &error);
+
+  yaml::Stream stream(text, sourceManager);
+  yaml::document_iterator document = stream.begin();
+  if (document == stream.end() || !document->getRoot() ||
+      isa<yaml::NullNode>(document->getRoot())) {
+    return !stream.failed();
+  }
+  auto *root = dyn_cast<yaml::MappingNode>(document->getRoot());
+  if (!root) {
+    error = "expected a mapping from checker names to their settings";
+    return false;
+  }
+
+  for (yaml::KeyValueNode &entry : *root) {
+    std::string checker, value;
+    if (!getScalar(entry.getKey(), checker)) {
+      error = error.empty() ? "expected a checker name" : error;
+      return false;
+    }
+    yaml::Node *settingsNode = entry.getValue();
+    if (getScalar(settingsNode, value)) {
+      if (!set(checker, "enabled", value, error)) {
+        return false;
+      }
+      continue;
+    }
+    auto *checkerSettings = dyn_cast_or_null<yaml::MappingNode>(settingsNode);
+    if (!checkerSettings) {
+      error = error.empty() ? "expected on, off or a mapping for " + checker
+                            : error;
+      return false;
+    }
+    for (yaml::KeyValueNode &setting : *checkerSettings) {
+      std::string key;
+      if (!getScalar(setting.getKey(), key) ||
+          !getScalar(setting.getValue(), value)) {
+        error = error.empty() ? "expected scalar settings for " + checker
+                              : error;
+        return false;
+      }
+      if (!set(checker, key, value, error)) {
+        return false;
+      }
+    }
+  }
+  return !stream.failed() && error.empty();
+}
+
+bool LintConfig::parseArgument(StringRef argument, std::string &error) {
+  std::pair<StringRef, StringRef> assignment = argument.split('=');
+  if (assignment.first == "enable" || assignment.first == "disable") {
+    SmallVector<StringRef, 8> checkers;
+    assignment.second.split(checkers, ',', -1, /*KeepEmpty=*/false);
+    for (StringRef checker : checkers) {
+      if (!set(checker.trim(), "enabled",
+               assignment.first == "enable" ? "true" : "false", error)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::pair<StringRef, StringRef> name = assignment.first.split('.');
+  if (name.second.empty() || argument.find('=') == StringRef::npos) {
+    error = "invalid setting '" + argument.str() +
+            "' (expected enable=<checkers>, disable=<checkers> or "
+            "<checker>.<key>=<value>)";
+    return false;
+  }
+  return set(name.first, name.second, assignment.second, error);
+}
+
+bool LintConfig::set(StringRef checker, StringRef key, StringRef value,
+                     std::string &error) {
+  CheckerSettings &checkerSettings = settings[checker.str()];
+  if (key == "enabled") {
+    if (!parseBool(value, checkerSettings.enabled)) {
+      error = "invalid value '" + value.str() + "' of " + checker.str() +
+              ".enabled (expected on or off)";
+      return false;
+    }
+    return true;
+  }
+  if (key == "severity") {
+    DiagnosticsEngine::Level level;
+    if (!parseLevel(value, level)) {
+      error = "invalid severity '" + value.str() + "' of " + checker.str() +
+              " (expected ignored, note, remark, warning, error or fatal)";
+      return false;
+    }
+    checkerSettings.severity = value.lower();
+    return true;
+  }
+  // A later setting of the same option replaces the earlier one.
+  auto &options = checkerSettings.options;
+  options.erase(std::remove_if(options.begin(), options.end(),
+                               [&](const std::pair<std::string, std::string>
+                                       &option) { return option.first == key; }),
+                options.end());
+  options.emplace_back(key, value);
+  return true;
+}
+
+bool LintConfig::validate(std::string &error) const {
+  CheckerList checkers = createAllCheckers();
+  for (const auto &entry : settings) {
+    auto checker = std::find_if(
+        checkers.begin(), checkers.end(),
+        [&](const std::unique_ptr<Checker> &checker) {
+          return checker->getName() == entry.first;
+        });
+    if (checker == checkers.end()) {
+      error = "unknown checker '" + entry.first + "'";
+      return false;
+    }
+    for (const auto &option : entry.second.options) {
+      if (!(*checker)->setOption(option.first, option.second)) {
+        error = "invalid option " + entry.first + "." + option.first + "=" +
+                option.second;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void LintConfig::apply(CheckerList &checkers) const {
+  checkers.erase(
+      std::remove_if(checkers.begin(), checkers.end(),
+                     [&](const std::unique_ptr<Checker> &checker) {
+                       auto it = settings.find(checker->getName().str());
+                       return it != settings.end() && !it->second.enabled;
+                     }),
+      checkers.end());
+
+  for (auto &checker : checkers) {
+    auto it = settings.find(checker->getName().str());
+    if (it == settings.end()) {
+      continue;
+    }
+    DiagnosticsEngine::Level level;
+    if (parseLevel(it->second.severity, level)) {
+      checker->overrideLevel(level);
+    }
+    for (const auto &option : it->second.options) {
+      checker->setOption(option.first, option.second);
+    }
+  }
+}
+
+std::string LintConfig::getFingerprint() const {
+  std::string fingerprint;
+  raw_string_ostream os(fingerprint);
+  for (const auto &entry : settings) {
+    os << entry.first << (entry.second.enabled ? " on " : " off ")
+       << entry.second.severity;
+    for (const auto &option : entry.second.options) {
+      os << ' ' << option.first << '=' << option.second;
+    }
+    os << '\n';
+  }
+  return os.str();
+}
+
+std::string findConfigFile(StringRef directory) {
+  SmallString<128> path(directory);
+  sys::fs::make_absolute(path);
+  while (!path.empty()) {
+    SmallString<128> candidate(path);
+    sys::path::append(candidate, CONFIG_FILE_NAME);
+    if (sys::fs::exists(candidate)) {
+      return candidate.str().str();
+    }
+    size_t size = path.size();
+    sys::path::remove_filename(path);
+    if (path.size() == size) {
+      break;
+    }
+  }
+  return "";
+}
+
+bool loadConfig(const std::vector<std::string> &arguments, LintConfig &config,
+                std::string &error) {
+  std::string configPath;
+  for (StringRef argument : arguments) {
+    if (argument.startswith("config=")) {
+      configPath = argument.drop_front(strlen("config=")).str();
+    }
+  }
+  if (configPath.empty()) {
+    SmallString<128> workingDirectory;
+    if (!sys::fs::current_path(workingDirectory)) {
+      configPath = findConfigFile(workingDirectory);
+    }
+  }
+  if (!configPath.empty() && !config.loadFile(configPath, error)) {
+    return false;
+  }
+
+  for (StringRef argument : arguments) {
+    if (!argument.startswith("config=") &&
+        !config.parseArgument(argument, error)) {
+      return false;
+    }
+  }
+  return config.validate(error);
+}
+
+} // namespace complint
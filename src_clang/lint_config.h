@@ -0,0 +1,91 @@
+//------------------------------------------------------------------------------
+// Per-checker configuration: enablement, severity and options.
+//
+// Contests enforce different rule sets. A .complint.yaml file, found in the
+// working directory or one of its parents, maps checker names to their
+// settings:
+//
+//   goto: off
+//   consecutive_newlines:
+//     severity: warning
+//     max_empty_lines: 3
+//   floating_point_comp:
+//     epsilon: EPSILON
+//
+// A scalar turns the checker on or off. In a mapping, "enabled" does the
+// same, "severity" sets the level of all its diagnostics (ignored, note,
+// remark, warning, error or fatal) and every other key is an option of the
+// checker. The same settings can be given as arguments, which override the
+// file:
+//
+//   enable=goto,no_float    disable=debug_macro
+//   goto.severity=warning   consecutive_newlines.max_empty_lines=3
+//   config=<path>           (instead of looking for .complint.yaml)
+//
+// Disabled checkers are removed from the checker list before the consumer is
+// created, so they register no matchers, and if none of the enabled checkers
+// inspects the text the buffer isn't scanned at all.
+//------------------------------------------------------------------------------
+#ifndef COMPETITIVE_LINT_LINT_CONFIG_H
+#define COMPETITIVE_LINT_LINT_CONFIG_H
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "llvm/ADT/StringRef.h"
+
+#include "checker.h"
+
+namespace complint {
+
+constexpr char CONFIG_FILE_NAME[] = ".complint.yaml";
+
+class LintConfig {
+public:
+  // Adds the settings of a .complint.yaml file.
+  bool loadFile(llvm::StringRef path, std::string &error);
+  bool parseYAML(llvm::StringRef text, std::string &error);
+
+  // Adds one setting given as an argument: enable=<checkers>,
+  // disable=<checkers> or <checker>.<key>=<value>. config= is handled by the
+  // callers, since it has to be loaded before all other arguments.
+  bool parseArgument(llvm::StringRef argument, std::string &error);
+
+  // Checks the checker names, severities and options against the available
+  // checkers, so apply() can't fail.
+  bool validate(std::string &error) const;
+
+  // Removes the disabled checkers and configures the others.
+  void apply(CheckerList &checkers) const;
+
+  // Text identifying the settings, for the key of the result cache.
+  std::string getFingerprint() const;
+
+private:
+  bool set(llvm::StringRef checker, llvm::StringRef key,
+           llvm::StringRef value, std::string &error);
+
+  struct CheckerSettings {
+    bool enabled = true;
+    std::string severity;
+    std::vector<std::pair<std::string, std::string>> options;
+  };
+  // Ordered by name, so the fingerprint doesn't depend on the input order.
+  std::map<std::string, CheckerSettings> settings;
+};
+
+// Path of the .complint.yaml in directory or the closest of its parents, or
+// an empty string if there is none.
+std::string findConfigFile(llvm::StringRef directory);
+
+// Loads the configuration for arguments of the form accepted by
+// LintConfig::parseArgument and config=<path>. Without config=, the
+// .complint.yaml of the working directory is used, if there is one.
+bool loadConfig(const std::vector<std::string> &arguments, LintConfig &config,
+                std::string &error);
+
+} // namespace complint
+
+#endif // COMPETITIVE_LINT_LINT_CONFIG_H
@@ -0,0 +1,342 @@
+//------------------------------------------------------------------------------
+// Shared driver of the text and AST checkers.
+//------------------------------------------------------------------------------
+#include "lint_consumer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "clang/AST/ASTContext.h"
+#include "clang/Basic/FileManager.h"
+#include "clang/Lex/Lexer.h"
+
+#include "main_file_traversal.h"
+
+namespace complint {
+
+using namespace clang;
+
+namespace {
+
+// Records the diagnostics of the translation unit for the structured output
+// and the statistics. Takes the place of the diagnostic client of the
+// compiler, which it forwards to.
+class PluginCollector : public FindingCollector {
+public:
+  PluginCollector(DiagnosticConsumer *next,
+                  std::unique_ptr<DiagnosticConsumer> ownedNext,
+                  FindingWriter *writer, StringRef mainFile,
+                  const LangOptions &langOptions)
+      : FindingCollector(next), ownedNext(std::move(ownedNext)),
+        writer(writer), mainFile(mainFile) {
+    // The compiler started the source file before the plugin was created.
+    this->langOptions = langOptions;
+  }
+
+  // Every plugin given a structured output or stats puts a collector in
+  // front of the previous client, so with several plugins on one command
+  // line all of them see every diagnostic. Each records those of its own
+  // checkers, and the outermost one those of the compiler as well, so every
+  // finding is written once.
+  void HandleDiagnostic(DiagnosticsEngine::Level level,
+                        const Diagnostic &info) override {
+    bool own = registry && !registry->getCheckerName(info.getID()).empty();
+    bool compiler = info.getID() < diag::DIAG_UPPER_LIMIT &&
+                    info.getDiags()->getClient() == this;
+    if (own || compiler) {
+      FindingCollector::HandleDiagnostic(level, info);
+      return;
+    }
+    DiagnosticConsumer::HandleDiagnostic(level, info);
+    if (next) {
+      next->HandleDiagnostic(level, info);
+    }
+  }
+
+  // Writes the findings of the translation unit to the structured output.
+  void EndSourceFile() override {
+    FindingCollector::EndSourceFile();
+    if (writer) {
+      writer->write(mainFile, findings);
+    }
+    findings.clear();
+  }
+
+private:
+  std::unique_ptr<DiagnosticConsumer> ownedNext;
+  FindingWriter *writer;
+  std::string mainFile;
+};
+
+ast_matchers::MatchFinder::MatchFinderOptions
+getFinderOptions(LintStats *stats) {
+  ast_matchers::MatchFinder::MatchFinderOptions options;
+  if (stats) {
+    options.CheckProfiling.emplace(stats->nodeMatchRecords);
+  }
+  return options;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+} // namespace
+
+LintConsumer::LintConsumer(CheckerList checkers, FindingCollector *collector,
+                           std::unique_ptr<LintStats> stats)
+    : checkers(std::move(checkers)), stats(std::move(stats)),
+      finder(getFinderOptions(this->stats.get())), collector(collector) {
+  for (auto &checker : this->checkers) {
+    if (this->stats) {
+      finder.setMatchCounter(
+          &this->stats->checkers[checker->getName()].matches);
+    }
+    checker->registerMatchers(finder);
+  }
+  finder.setMatchCounter(nullptr);
+}
+
+LintConsumer::~LintConsumer() {
+  if (collector) {
+    collector->setRegistry(nullptr);
+  }
+  if (preprocessor) {
+    preprocessor->removeCommentHandler(this);
+  }
+}
+
+void LintConsumer::watchComments(Preprocessor &preprocessor) {
+  // In the incremental mode, the comments are checked with the text.
+  bool checksComments = std::any_of(
+      checkers.begin(), checkers.end(),
+      [](const std::unique_ptr<Checker> &checker) {
+        return checker->checksComments();
+      });
+  if (incremental || !checksComments) {
+    return;
+  }
+  this->preprocessor = &preprocessor;
+  preprocessor.addCommentHandler(this);
+}
+
+bool LintConsumer::HandleComment(Preprocessor &preprocessor,
+                                 SourceRange comment) {
+  SourceManager &sourceManager = preprocessor.getSourceManager();
+  if (!sourceManager.isWrittenInMainFile(comment.getBegin())) {
+    return false;
+  }
+  if (!registry) {
+    pendingComments.push_back(comment);
+    return false;
+  }
+  checkComment(sourceManager, comment);
+  // Nothing was pushed back into the token stream.
+  return false;
+}
+
+void LintConsumer::checkComment(SourceManager &sourceManager,
+                                SourceRange comment) {
+  bool invalid = false;
+  StringRef text = Lexer::getSourceText(CharSourceRange::getCharRange(comment),
+                                        sourceManager,
+                                        preprocessor->getLangOpts(), &invalid);
+  if (invalid) {
+    return;
+  }
+  DiagnosticsEngine &diagnostics = preprocessor->getDiagnostics();
+  for (auto &checker : checkers) {
+    if (!checker->checksComments()) {
+      continue;
+    }
+    ScopedStopwatch stopwatch(
+        stats ? &stats->checkers[checker->getName()].sourceSeconds : nullptr);
+    checker->checkComment(diagnostics, sourceManager, comment, text);
+  }
+}
+
+void LintConsumer::Initialize(ASTContext &context) {
+  // Set before any of the returns below, so the parse time is measured even
+  // without the text checks.
+  parseStart = std::chrono::steady_clock::now();
+  registry = llvm::make_unique<DiagnosticRegistry>(context.getDiagnostics());
+  for (auto &checker : checkers) {
+    checker->registerDiagnostics(*registry);
+  }
+  if (collector) {
+    collector->setRegistry(registry.get());
+  }
+  for (SourceRange comment : pendingComments) {
+    checkComment(context.getSourceManager(), comment);
+  }
+  pendingComments.clear();
+
+  // Checkers of the AST only don't need the buffer.
+  bool checksSource = std::any_of(
+      checkers.begin(), checkers.end(),
+      [](const std::unique_ptr<Checker> &checker) {
+        return checker->checksSource();
+      });
+  if (incremental || !checksSource) {
+    return;
+  }
+
+  auto &sourceManager = context.getSourceManager();
+  auto mainFile = sourceManager.getMainFileID();
+  bool error = false;
+  StringRef source = sourceManager.getBufferData(mainFile, &error);
+  if (error) {
+    return;
+  }
+
+  if (!stats) {
+    SourceScan scan(source);
+    for (auto &checker : checkers) {
+      checker->checkSource(context.getDiagnostics(), sourceManager, mainFile,
+                           scan);
+    }
+    return;
+  }
+
+  std::unique_ptr<SourceScan> scan;
+  {
+    ScopedStopwatch stopwatch(&stats->scanSeconds);
+    scan = llvm::make_unique<SourceScan>(source);
+  }
+  stats->scannedBytes = source.size();
+  stats->scannedLines = scan->getLineCount();
+  stats->scannedComments = scan->getComments().size();
+  for (auto &checker : checkers) {
+    ScopedStopwatch stopwatch(
+        &stats->checkers[checker->getName()].sourceSeconds);
+    checker->checkSource(context.getDiagnostics(), sourceManager, mainFile,
+                         *scan);
+  }
+  // The text checks are timed on their own, not as part of the parse.
+  parseStart = std::chrono::steady_clock::now();
+}
+
+void LintConsumer::HandleTranslationUnit(ASTContext &context) {
+  if (!stats) {
+    MainFileTraversal(context, checkers, finder, nullptr, limit).run();
+    return;
+  }
+
+  stats->parseSeconds = secondsSince(parseStart);
+  {
+    ScopedStopwatch stopwatch(&stats->traversalSeconds);
+    MainFileTraversal(context, checkers, finder, stats.get(), limit).run();
+  }
+  printStats(context);
+}
+
+void LintConsumer::printStats(ASTContext &context) {
+  if (collector) {
+    for (const Finding &finding : collector->getFindings()) {
+      if (!finding.checker.empty()) {
+        ++stats->checkers[finding.checker].reports;
+      }
+    }
+  }
+
+  auto &sourceManager = context.getSourceManager();
+  const FileEntry *mainFile =
+      sourceManager.getFileEntryForID(sourceManager.getMainFileID());
+  stats->print(llvm::errs(), mainFile ? mainFile->getName() : "<stdin>");
+}
+
+std::unique_ptr<ASTConsumer>
+LintPluginAction::CreateASTConsumer(CompilerInstance &CI,
+                                    llvm::StringRef InFile) {
+  CheckerList checkers = createCheckers();
+  config.apply(checkers);
+  if (!writer && !printStats) {
+    auto consumer = llvm::make_unique<LintConsumer>(std::move(checkers));
+    consumer->watchComments(CI.getPreprocessor());
+    return std::move(consumer);
+  }
+
+  DiagnosticsEngine &diagnostics = CI.getDiagnostics();
+  std::unique_ptr<DiagnosticConsumer> ownedClient = diagnostics.takeClient();
+  auto *collector =
+      new PluginCollector(diagnostics.getClient(), std::move(ownedClient),
+                          writer, InFile, CI.getLangOpts());
+  diagnostics.setClient(collector, /*ShouldOwnClient=*/true);
+
+  std::unique_ptr<LintStats> stats;
+  if (printStats) {
+    stats = llvm::make_unique<LintStats>(statsFormat);
+  }
+  auto consumer = llvm::make_unique<LintConsumer>(std::move(checkers),
+                                                  collector, std::move(stats));
+  consumer->watchComments(CI.getPreprocessor());
+  return std::move(consumer);
+}
+
+bool LintPluginAction::ParseArgs(const CompilerInstance &CI,
+                                 const std::vector<std::string> &args) {
+  DiagnosticsEngine &diagnostics = CI.getDiagnostics();
+  OutputFormat format = OutputFormat::Text;
+  std::string outputPath = "-";
+  std::vector<std::string> configArgs;
+  for (const auto &arg : args) {
+    StringRef argRef(arg);
+    if (argRef.startswith("format=") &&
+        parseOutputFormat(argRef.drop_front(strlen("format=")), format)) {
+      continue;
+    }
+    if (argRef.startswith("output=")) {
+      outputPath = argRef.drop_front(strlen("output=")).str();
+      continue;
+    }
+    if (argRef == "stats" || argRef == "stats=table" ||
+        argRef == "stats=json") {
+      printStats = true;
+      statsFormat = argRef == "stats=json" ? LintStats::Format::JSON
+                                           : LintStats::Format::Table;
+      continue;
+    }
+    // Everything else configures the checkers.
+    configArgs.push_back(arg);
+  }
+
+  std::string configError;
+  if (!loadConfig(configArgs, config, configError)) {
+    unsigned ID = diagnostics.getCustomDiagID(
+        DiagnosticsEngine::Error, "invalid lint configuration: %0");
+    diagnostics.Report(ID) << configError;
+    return false;
+  }
+
+  if (format == OutputFormat::Text) {
+    return true;
+  }
+  std::string error;
+  writer = FindingWriter::open(format, outputPath, error);
+  if (!writer) {
+    unsigned ID = diagnostics.getCustomDiagID(
+        DiagnosticsEngine::Error, "can't open the lint output: %0");
+    diagnostics.Report(ID) << error;
+    return false;
+  }
+  return true;
+}
+
+std::unique_ptr<ASTConsumer>
+LintFrontendAction::CreateASTConsumer(CompilerInstance &CI, llvm::StringRef) {
+  CheckerList checkers = createAllCheckers();
+  if (config) {
+    config->apply(checkers);
+  }
+  auto consumer = llvm::make_unique<LintConsumer>(std::move(checkers),
+                                                  collector);
+  if (incremental) {
+    consumer->setIncremental(limit);
+  }
+  consumer->watchComments(CI.getPreprocessor());
+  return std::move(consumer);
+}
+
+} // namespace complint
@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+// AST consumer and plugin action that run a list of checkers.
+//
+// The text checkers share one read of the main-file buffer and the AST
+// checkers share one MainFileTraversal, so the main-file part of the
+// translation unit is traversed once no matter how many checkers are enabled.
+//------------------------------------------------------------------------------
+#ifndef COMPETITIVE_LINT_LINT_CONSUMER_H
+#define COMPETITIVE_LINT_LINT_CONSUMER_H
+
+#include "clang/AST/ASTConsumer.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/FrontendAction.h"
+#include "clang/Lex/Preprocessor.h"
+
+#include "checker.h"
+#include "finding_writer.h"
+#include "findings.h"
+#include "lint_config.h"
+#include "lint_stats.h"
+#include "main_file_traversal.h"
+
+namespace complint {
+
+class LintConsumer : public clang::ASTConsumer, public clang::CommentHandler {
+public:
+  // The checkers of the diagnostics recorded by collector, if any, are
+  // looked up in the registry of this consumer. With stats, the run is
+  // measured and the statistics are printed to stderr at the end.
+  explicit LintConsumer(CheckerList checkers,
+                        FindingCollector *collector = nullptr,
+                        std::unique_ptr<LintStats> stats = nullptr);
+  ~LintConsumer() override;
+
+  // Runs the AST part of an incremental lint (see incremental_lint.h): the
+  // text checks are run on their own, so they are skipped here, and the
+  // traversal is restricted by limit, if not null.
+  void setIncremental(TraversalLimit *limit) {
+    incremental = true;
+    this->limit = limit;
+  }
+
+  // Passes the comments of the main file to the checkers as the
+  // preprocessor lexes them, if any checker inspects comments.
+  void watchComments(clang::Preprocessor &preprocessor);
+
+  void Initialize(clang::ASTContext &context) override;
+  void HandleTranslationUnit(clang::ASTContext &context) override;
+  bool HandleComment(clang::Preprocessor &preprocessor,
+                     clang::SourceRange comment) override;
+
+private:
+  CheckerList checkers;
+  std::unique_ptr<LintStats> stats;
+  CheckerMatchFinder finder;
+  std::unique_ptr<DiagnosticRegistry> registry;
+  FindingCollector *collector;
+  std::chrono::steady_clock::time_point parseStart;
+  bool incremental = false;
+  TraversalLimit *limit = nullptr;
+  clang::Preprocessor *preprocessor = nullptr;
+  // Comments lexed before the diagnostics of the checkers were registered.
+  std::vector<clang::SourceRange> pendingComments;
+
+  void checkComment(clang::SourceManager &sourceManager,
+                    clang::SourceRange comment);
+  void printStats(clang::ASTContext &context);
+};
+
+// Base of the plugin actions. Subclasses only choose the checkers to run.
+//
+// The plugins take these arguments, e.g.
+//   -Xclang -plugin-arg-competitive_lint -Xclang format=jsonl
+//   -Xclang -plugin-arg-competitive_lint -Xclang output=findings.jsonl
+//   -Xclang -plugin-arg-competitive_lint -Xclang stats
+// format is text (the default), jsonl or sarif; see finding_writer.h. The
+// structured output goes to stdout unless output is given, and the text
+// diagnostics are still printed. stats, or stats=json, prints the timing and
+// counters of the run to stderr; see lint_stats.h. All other arguments, e.g.
+//   -Xclang -plugin-arg-competitive_lint -Xclang disable=goto
+// configure the checkers, on top of .complint.yaml; see lint_config.h.
+class LintPluginAction : public clang::PluginASTAction {
+protected:
+  std::unique_ptr<clang::ASTConsumer>
+  CreateASTConsumer(clang::CompilerInstance &CI, llvm::StringRef) override;
+
+  bool ParseArgs(const clang::CompilerInstance &CI,
+                 const std::vector<std::string> &args) override;
+
+  virtual CheckerList createCheckers() = 0;
+
+private:
+  FindingWriter *writer = nullptr;
+  LintConfig config;
+  bool printStats = false;
+  LintStats::Format statsFormat = LintStats::Format::Table;
+};
+
+// Frontend action running all checkers, or those enabled by config, used by
+// the comp-lint tool.
+class LintFrontendAction : public clang::ASTFrontendAction {
+public:
+  explicit LintFrontendAction(FindingCollector *collector = nullptr,
+                              const LintConfig *config = nullptr)
+      : collector(collector), config(config) {}
+
+  // Runs the AST part of an incremental lint; see LintConsumer.
+  void setIncremental(TraversalLimit *limit) {
+    incremental = true;
+    this->limit = limit;
+  }
+
+protected:
+  std::unique_ptr<clang::ASTConsumer>
+  CreateASTConsumer(clang::CompilerInstance &CI, llvm::StringRef) override;
+
+private:
+  FindingCollector *collector;
+  const LintConfig *config;
+  bool incremental = false;
+  TraversalLimit *limit = nullptr;
+};
+
+} // namespace complint
+
+#endif // COMPETITIVE_LINT_LINT_CONSUMER_H
@@ -0,0 +1,293 @@
+//------------------------------------------------------------------------------
+// Linting of single files through ToolInvocation.
+//------------------------------------------------------------------------------
+#include "lint_runner.h"
+
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+
+#include "clang/Frontend/FrontendDiagnostic.h"
+#include "clang/Frontend/TextDiagnosticPrinter.h"
+#include "clang/Tooling/Tooling.h"
+
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "findings.h"
+#include "lint_consumer.h"
+#include "source_scan.h"
+#include "text_lint.h"
+
+namespace complint {
+
+using namespace clang;
+
+namespace {
+
+std::string getOverBudgetNote(const std::string &path) {
+  return "comp-lint: " + path +
+         " needs more memory than allowed; only the text checks were run\n";
+}
+
+// Notices the errors of loading a PCH, e.g. a truncated one or one whose
+// headers changed after it was built.
+class PCHErrorCollector : public FindingCollector {
+public:
+  using FindingCollector::FindingCollector;
+
+  void HandleDiagnostic(DiagnosticsEngine::Level level,
+                        const Diagnostic &info) override {
+    unsigned id = info.getID();
+    if (level >= DiagnosticsEngine::Error &&
+        ((id >= diag::DIAG_START_SERIALIZATION && id < diag::DIAG_START_LEX) ||
+         id == diag::err_fe_unable_to_load_pch)) {
+      pchError = true;
+    }
+    FindingCollector::HandleDiagnostic(level, info);
+  }
+
+  bool hasPCHError() const { return pchError; }
+
+private:
+  bool pchError = false;
+};
+
+} // namespace
+
+LintResult LintRunner::lintFile(FileManager &fileManager,
+                                const std::string &path) const {
+  if (textOnly) {
+    return lintText(path, nullptr);
+  }
+
+  // Without the contents the compiler is run on the path anyway, so the
+  // error is reported like any other diagnostic.
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if (!buffer) {
+    return compile(fileManager, path, nullptr);
+  }
+  return lintBuffer(fileManager, path, (*buffer)->getBuffer());
+}
+
+LintResult LintRunner::lintBuffer(FileManager &fileManager,
+                                  const std::string &path,
+                                  StringRef source) const {
+  if (textOnly) {
+    return lintText(path, &source);
+  }
+
+  LintResult result;
+  if (resultCache && resultCache->lookup(source, result)) {
+    result.output = replayOutput(result, path);
+    result.mainFile = path;
+    return result;
+  }
+  result = lintSource(fileManager, path, source);
+  if (resultCache) {
+    resultCache->store(source, result);
+  }
+  return result;
+}
+
+LintResult LintRunner::lintIncremental(FileManager &fileManager,
+                                       const std::string &path,
+                                       StringRef source,
+                                       LintSession &session) const {
+  LintResult result = lintText(path, &source);
+  result.output.clear();
+  if (textOnly) {
+    return result;
+  }
+
+  std::lock_guard<std::mutex> lock(session.mutex);
+  std::string storage;
+  StringRef compiled;
+  size_t parsedSize = prepareCompiledSource(source, storage, compiled);
+  MemoryReservation reservation(memoryBudget, estimateLintMemory(parsedSize));
+  if (!reservation.isAcquired()) {
+    session.valid = false;
+    result.output = getOverBudgetNote(path);
+    return result;
+  }
+
+  // E.g. a comment turning a checker off was added, which looks like an edit
+  // of trivia but changes findings everywhere.
+  if (session.valid && isGlobalEdit(session.source, source)) {
+    session.valid = false;
+  }
+  SourceScan newScan(source);
+  std::vector<Finding> astFindings;
+  Edit edit;
+  if (session.valid) {
+    edit = findEdit(session.source, source);
+  }
+  SourceScan oldScan(session.valid ? StringRef(session.source) : StringRef());
+
+  if (session.valid &&
+      (edit.isEmpty() || isTriviaEdit(oldScan, newScan, edit))) {
+    // Same tokens, same AST: only the positions change.
+    for (Finding finding : session.astFindings) {
+      if (shiftFinding(finding, edit, newScan)) {
+        astFindings.push_back(std::move(finding));
+      }
+    }
+  } else if (session.valid && !editsDirective(oldScan, newScan, edit)) {
+    TraversalLimit limit;
+    limit.begin = edit.begin;
+    limit.end = edit.newEnd;
+    astFindings = compile(fileManager, path, &compiled, true, &limit).findings;
+    reuseFindings(session.astFindings, edit, limit, newScan, astFindings);
+  } else {
+    astFindings = compile(fileManager, path, &compiled, true).findings;
+  }
+
+  session.valid = true;
+  session.source = source.str();
+  session.astFindings = astFindings;
+  result.findings.insert(result.findings.end(),
+                         std::make_move_iterator(astFindings.begin()),
+                         std::make_move_iterator(astFindings.end()));
+  return result;
+}
+
+LintResult LintRunner::lintSource(FileManager &fileManager,
+                                  const std::string &path,
+                                  StringRef source) const {
+  std::string storage;
+  StringRef compiled;
+  size_t parsedSize = prepareCompiledSource(source, storage, compiled);
+
+  MemoryReservation reservation(memoryBudget, estimateLintMemory(parsedSize));
+  if (!reservation.isAcquired()) {
+    LintResult result = lintText(path, &source);
+    result.output += getOverBudgetNote(path);
+    return result;
+  }
+  if (compiled.data() == source.data()) {
+    return compile(fileManager, path, &source);
+  }
+
+  // The text and comment checks see the original source and the AST ones the
+  // elided copy, which has the same offsets.
+  LintResult result = lintText(path, &source);
+  LintResult astResult = compile(fileManager, path, &compiled, true);
+  result.output += astResult.output;
+  result.findings.insert(result.findings.end(),
+                         std::make_move_iterator(astResult.findings.begin()),
+                         std::make_move_iterator(astResult.findings.end()));
+  return result;
+}
+
+size_t LintRunner::prepareCompiledSource(StringRef source,
+                                         std::string &storage,
+                                         StringRef &compiled) const {
+  compiled = source;
+  size_t blanked =
+      elisionThreshold
+          ? elideLargeInitializers(source, elisionThreshold, storage)
+          : 0;
+  if (blanked) {
+    compiled = storage;
+  }
+  return source.size() - blanked;
+}
+
+LintResult LintRunner::compile(FileManager &fileManager,
+                               const std::string &path,
+                               const StringRef *source, bool incremental,
+                               TraversalLimit *limit) const {
+  std::string pch;
+  if (source && pchCache) {
+    pch = pchCache->getPCHFor(*source);
+  }
+  bool pchFailed = false;
+  LintResult result = compileWithPCH(fileManager, path, source, pch,
+                                     incremental, limit, pchFailed);
+  if (pchFailed) {
+    // A PCH which can't be loaded is handled like one which failed to build:
+    // the file is compiled again without it.
+    pchCache->markUnusable(*source);
+    result = compileWithPCH(fileManager, path, source, "", incremental, limit,
+                            pchFailed);
+  }
+  return result;
+}
+
+LintResult LintRunner::compileWithPCH(FileManager &fileManager,
+                                      const std::string &path,
+                                      const StringRef *source,
+                                      const std::string &pch, bool incremental,
+                                      TraversalLimit *limit,
+                                      bool &pchFailed) const {
+  std::vector<std::string> args = commandLine;
+  if (!pch.empty()) {
+    args.push_back("-include-pch");
+    args.push_back(pch);
+  }
+  args.push_back(path);
+
+  LintResult result;
+  llvm::raw_string_ostream outputStream(result.output);
+  IntrusiveRefCntPtr<DiagnosticOptions> diagnosticOptions =
+      new DiagnosticOptions();
+  TextDiagnosticPrinter printer(outputStream, diagnosticOptions.get());
+  PCHErrorCollector collector(&printer);
+
+  auto action = llvm::make_unique<LintFrontendAction>(&collector, config);
+  if (incremental) {
+    action->setIncremental(limit);
+  }
+  tooling::ToolInvocation invocation(std::move(args), action.release(),
+                                     &fileManager);
+  if (source) {
+    invocation.mapVirtualFile(path, *source);
+  }
+  invocation.setDiagnosticConsumer(&collector);
+  invocation.run();
+  outputStream.flush();
+
+  pchFailed = !pch.empty() && collector.hasPCHError();
+  result.findings = collector.getFindings();
+  result.mainFile = path;
+  return result;
+}
+
+bool LintRunner::isGlobalEdit(StringRef oldSource, StringRef newSource) const {
+  CheckerList checkers = createAllCheckers();
+  if (config) {
+    config->apply(checkers);
+  }
+  return std::any_of(checkers.begin(), checkers.end(),
+                     [&](const std::unique_ptr<Checker> &checker) {
+                       return checker->isGlobalEdit(oldSource, newSource);
+                     });
+}
+
+LintResult LintRunner::lintText(const std::string &path,
+                                const StringRef *source) const {
+  LintResult result;
+  llvm::raw_string_ostream outputStream(result.output);
+  IntrusiveRefCntPtr<DiagnosticOptions> diagnosticOptions =
+      new DiagnosticOptions();
+  TextDiagnosticPrinter printer(outputStream, diagnosticOptions.get());
+  FindingCollector collector(&printer);
+
+  CheckerList checkers = createAllCheckers();
+  if (config) {
+    config->apply(checkers);
+  }
+  if (source) {
+    lintSourceBuffer(llvm::MemoryBuffer::getMemBufferCopy(*source, path),
+                     checkers, collector);
+  } else if (!lintSourceText(path, checkers, collector)) {
+    outputStream << "comp-lint: can't read " << path << "\n";
+  }
+  outputStream.flush();
+
+  result.findings = collector.getFindings();
+  result.mainFile = path;
+  return result;
+}
+
+} // namespace complint
@@ -0,0 +1,107 @@
+//------------------------------------------------------------------------------
+// Lints one file at a time for the comp-lint tool, using its caches.
+//
+// Shared by the batch mode and the daemon (see lint_server.h). The main file
+// is read once and handed to the compiler from memory, so the result cache
+// key, the PCH lookup and the linted code always see the same bytes, even
+// when the file changes on disk in between.
+//
+// Huge generated submissions can be compiled with their constant tables
+// elided, and are admitted by their estimated memory into a budget shared by
+// all workers (see large_input.h).
+//------------------------------------------------------------------------------
+#ifndef COMPETITIVE_LINT_LINT_RUNNER_H
+#define COMPETITIVE_LINT_LINT_RUNNER_H
+
+#include <string>
+#include <vector>
+
+#include "clang/Basic/FileManager.h"
+
+#include "llvm/ADT/StringRef.h"
+
+#include "incremental_lint.h"
+#include "large_input.h"
+#include "lint_config.h"
+#include "main_file_traversal.h"
+#include "pch_cache.h"
+#include "result_cache.h"
+
+namespace complint {
+
+class LintRunner {
+public:
+  // commandLine starts with the compiler and doesn't contain the input. The
+  // caches may be null. With textOnly, only the text checks are run. Without
+  // a config, all checkers are run with their defaults.
+  LintRunner(std::vector<std::string> commandLine, PCHCache *pchCache,
+             ResultCache *resultCache, bool textOnly,
+             const LintConfig *config = nullptr)
+      : commandLine(std::move(commandLine)), pchCache(pchCache),
+        resultCache(resultCache), textOnly(textOnly), config(config) {}
+
+  // Compiles the files within budget, if it isn't null, and elides their
+  // constant tables of at least elisionThreshold bytes, unless it is 0.
+  void setLargeInputLimits(MemoryBudget *budget, size_t elisionThreshold) {
+    memoryBudget = budget;
+    this->elisionThreshold = elisionThreshold;
+  }
+
+  // Lints the file at path. Thread-safe, as long as every thread uses a
+  // FileManager of its own.
+  LintResult lintFile(clang::FileManager &fileManager,
+                      const std::string &path) const;
+
+  // Lints source as if it were the contents of the file at path.
+  LintResult lintBuffer(clang::FileManager &fileManager,
+                        const std::string &path, llvm::StringRef source) const;
+
+  // Lints source as the next version of the buffer of session, redoing only
+  // what the edit since the previous version can have changed (see
+  // incremental_lint.h). The result cache isn't used and the output only has
+  // the note of lintBuffer for a buffer over the memory budget; the findings
+  // are the same as those of lintBuffer.
+  LintResult lintIncremental(clang::FileManager &fileManager,
+                             const std::string &path, llvm::StringRef source,
+                             LintSession &session) const;
+
+private:
+  std::vector<std::string> commandLine;
+  PCHCache *pchCache;
+  ResultCache *resultCache;
+  bool textOnly;
+  const LintConfig *config;
+  MemoryBudget *memoryBudget = nullptr;
+  size_t elisionThreshold = 0;
+
+  // Runs all checks on source, compiling it with its tables elided.
+  LintResult lintSource(clang::FileManager &fileManager,
+                        const std::string &path, llvm::StringRef source) const;
+  // Sets compiled to the buffer to compile instead of source, or to source
+  // itself. storage keeps an elided copy alive. Returns the number of bytes
+  // left to parse, which the memory estimate is based on.
+  size_t prepareCompiledSource(llvm::StringRef source, std::string &storage,
+                               llvm::StringRef &compiled) const;
+  // With incremental, only the AST part is run, restricted by limit if it
+  // isn't null.
+  LintResult compile(clang::FileManager &fileManager, const std::string &path,
+                     const llvm::StringRef *source, bool incremental = false,
+                     TraversalLimit *limit = nullptr) const;
+  // Compiles with the PCH at pch, unless it is empty. Sets pchFailed if the
+  // PCH couldn't be loaded.
+  LintResult compileWithPCH(clang::FileManager &fileManager,
+                            const std::string &path,
+                            const llvm::StringRef *source,
+                            const std::string &pch, bool incremental,
+                            TraversalLimit *limit, bool &pchFailed) const;
+  LintResult lintText(const std::string &path,
+                      const llvm::StringRef *source) const;
+  // Whether a checker can change its findings outside of the edit from
+  // oldSource to newSource (see Checker::isGlobalEdit).
+  bool isGlobalEdit(llvm::StringRef oldSource,
+                    llvm::StringRef newSource) const;
+};
+
+} // namespace complint
+
+#endif // COMPETITIVE_LINT_LINT_RUNNER_H
@@ -0,0 +1,292 @@
+//------------------------------------------------------------------------------
+// Unix socket server of the lint daemon.
+//------------------------------------------------------------------------------
+#include "lint_server.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "llvm/Support/raw_ostream.h"
+
+#include "finding_writer.h"
+
+namespace complint {
+
+using namespace clang;
+
+// Largest buffer accepted in a request.
+constexpr size_t MAX_BUFFER_SIZE = 64 << 20;
+
+// Longest request line accepted, enough for any path.
+constexpr size_t MAX_LINE_LENGTH = 64 << 10;
+
+// Edited buffers remembered for the update requests.
+constexpr size_t MAX_SESSIONS = 256;
+
+// Buffered reads and complete writes on a connected socket.
+class Connection {
+public:
+  explicit Connection(int fd) : fd(fd) {}
+
+  // Reads up to the next line break, which isn't stored. Returns false at
+  // the end of the stream, or once the line is longer than MAX_LINE_LENGTH,
+  // which isTooLong tells apart.
+  bool readLine(std::string &line) {
+    line.clear();
+    while (true) {
+      size_t newline = pending.find('\n', position);
+      size_t end = newline != std::string::npos ? newline : pending.size();
+      line.append(pending, position, end - position);
+      position = newline != std::string::npos ? newline + 1 : end;
+      if (line.size() > MAX_LINE_LENGTH) {
+        tooLong = true;
+        return false;
+      }
+      if (newline != std::string::npos) {
+        return true;
+      }
+      if (!fill()) {
+        return false;
+      }
+    }
+  }
+
+  bool isTooLong() const { return tooLong; }
+
+  bool readBytes(size_t count, std::string &bytes) {
+    bytes.clear();
+    while (bytes.size() < count) {
+      if (position == pending.size() && !fill()) {
+        return false;
+      }
+      size_t chunk = std::min(count - bytes.size(), pending.size() - position);
+      bytes.append(pending, position, chunk);
+      position += chunk;
+    }
+    return true;
+  }
+
+  bool write(StringRef data) {
+    while (!data.empty()) {
+      // A client which went away must not kill the daemon with SIGPIPE.
+      ssize_t written = send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+      if (written < 0 && errno == EINTR) {
+        continue;
+      }
+      if (written <= 0) {
+        return false;
+      }
+      data = data.drop_front(written);
+    }
+    return true;
+  }
+
+private:
+  int fd;
+  std::string pending;
+  size_t position = 0;
+  bool tooLong = false;
+
+  bool fill() {
+    char chunk[64 * 1024];
+    ssize_t count;
+    do {
+      count = read(fd, chunk, sizeof(chunk));
+    } while (count < 0 && errno == EINTR);
+    if (count <= 0) {
+      return false;
+    }
+    pending.assign(chunk, count);
+    position = 0;
+    return true;
+  }
+};
+
+namespace {
+
+std::string formatError(StringRef path, StringRef message) {
+  std::string response;
+  llvm::raw_string_ostream os(response);
+  os << "{\"file\":";
+  writeJSONString(os, path);
+  os << ",\"ok\":false,\"error\":";
+  writeJSONString(os, message);
+  os << "}\n";
+  return os.str();
+}
+
+std::string formatResult(StringRef path, const LintResult &result) {
+  std::string response;
+  llvm::raw_string_ostream os(response);
+  os << "{\"file\":";
+  writeJSONString(os, path);
+  os << ",\"ok\":true,\"problems\":"
+     << (hasProblems(result.findings) ? "true" : "false") << ",\"findings\":[";
+  for (size_t i = 0; i < result.findings.size(); ++i) {
+    if (i) {
+      os << ',';
+    }
+    writeFindingJSON(os, path, result.findings[i]);
+  }
+  os << "]}\n";
+  return os.str();
+}
+
+} // namespace
+
+bool LintServer::run(unsigned threadCount, std::string &error) {
+  sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (socketPath.size() >= sizeof(address.sun_path)) {
+    error = "socket path too long: " + socketPath;
+    return false;
+  }
+  strcpy(address.sun_path, socketPath.c_str());
+
+  int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listener < 0) {
+    error = std::string("socket: ") + strerror(errno);
+    return false;
+  }
+  // The socket of a daemon which wasn't shut down cleanly is still there.
+  unlink(socketPath.c_str());
+  // Requests name files to read, so only the user of the daemon may connect.
+  // The socket is created with mode 0600 rather than changed after bind, so
+  // there is no moment in which others can connect.
+  mode_t oldMask = umask(0177);
+  int bound = bind(listener, reinterpret_cast<sockaddr *>(&address),
+                   sizeof(address));
+  umask(oldMask);
+  if (bound != 0 || listen(listener, SOMAXCONN) != 0) {
+    error = socketPath + ": " + strerror(errno);
+    close(listener);
+    return false;
+  }
+
+  // Every worker accepts connections itself, so a slow request only holds
+  // up its own worker.
+  std::vector<std::thread> workers;
+  for (unsigned i = 0; i < threadCount; ++i) {
+    workers.emplace_back([this, listener] { work(listener); });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  close(listener);
+  return true;
+}
+
+void LintServer::work(int listener) {
+  FileSystemOptions fileSystemOptions;
+  IntrusiveRefCntPtr<FileManager> fileManager(
+      new FileManager(fileSystemOptions));
+
+  while (true) {
+    int connection = accept(listener, nullptr, nullptr);
+    if (connection < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      llvm::errs() << "comp-lint: accept: " << strerror(errno) << "\n";
+      return;
+    }
+    serve(connection, *fileManager);
+    close(connection);
+  }
+}
+
+void LintServer::serve(int fd, FileManager &fileManager) {
+  Connection connection(fd);
+  std::string request;
+  bool keepOpen = true;
+  while (keepOpen && connection.readLine(request)) {
+    StringRef line = StringRef(request).trim();
+    if (line.empty()) {
+      continue;
+    }
+    std::string response =
+        handleRequest(connection, line, fileManager, keepOpen);
+    if (!connection.write(response)) {
+      return;
+    }
+  }
+  // The rest of the line can't be skipped without reading it, so the
+  // connection is closed.
+  if (connection.isTooLong()) {
+    connection.write(formatError("", "request longer than 64 KB"));
+  }
+}
+
+std::string LintServer::handleRequest(Connection &connection,
+                                      StringRef request,
+                                      FileManager &fileManager,
+                                      bool &keepOpen) {
+  std::pair<StringRef, StringRef> command = request.split(' ');
+  if (command.first == "lint") {
+    std::string path = command.second.str();
+    if (path.empty()) {
+      return formatError("", "lint: missing path");
+    }
+    return formatResult(path, runner.lintFile(fileManager, path));
+  }
+
+  if (command.first == "buffer" || command.first == "update") {
+    std::string name = command.first.str();
+    std::pair<StringRef, StringRef> arguments = command.second.split(' ');
+    size_t length;
+    std::string path = arguments.second.str();
+    // Without a valid length the rest of the stream can't be parsed.
+    if (arguments.first.getAsInteger(10, length) || path.empty() ||
+        length > MAX_BUFFER_SIZE) {
+      keepOpen = false;
+      return formatError(path, name + ": expected <length> <path>, with a "
+                                      "length of at most 64 MB");
+    }
+    std::string source;
+    if (!connection.readBytes(length, source)) {
+      keepOpen = false;
+      return formatError(path, name + ": connection closed in the buffer");
+    }
+    if (name == "update") {
+      return formatResult(path, runner.lintIncremental(fileManager, path,
+                                                       source,
+                                                       *getSession(path)));
+    }
+    return formatResult(path, runner.lintBuffer(fileManager, path, source));
+  }
+
+  return formatError("", "unknown request: " + request.str());
+}
+
+std::shared_ptr<LintSession> LintServer::getSession(StringRef path) {
+  std::lock_guard<std::mutex> lock(sessionsMutex);
+  SessionEntry &entry = sessions[path];
+  if (!entry.session) {
+    entry.session = std::make_shared<LintSession>();
+  }
+  entry.lastUse = ++useCount;
+  std::shared_ptr<LintSession> session = entry.session;
+
+  if (sessions.size() > MAX_SESSIONS) {
+    // A session still in use by another worker lives on in its shared_ptr.
+    auto oldest = sessions.begin();
+    for (auto it = sessions.begin(); it != sessions.end(); ++it) {
+      if (it->second.lastUse < oldest->second.lastUse) {
+        oldest = it;
+      }
+    }
+    sessions.erase(oldest);
+  }
+  return session;
+}
+
+} // namespace complint
@@ -0,0 +1,86 @@
+//------------------------------------------------------------------------------
+// comp-lint --serve: a long-running lint daemon on a Unix domain socket.
+//
+// A lint through the plugins pays for starting clang, loading the plugins and
+// reading the system headers every time. The daemon keeps all of it warm: the
+// workers, their FileManagers with the header lookups, the PCH and result
+// caches. Several clients are served at once, one connection per worker.
+//
+// The protocol is line based. A connection carries any number of requests:
+//
+//   lint <path>\n                      lints the file at path
+//   buffer <length> <path>\n<bytes>    lints length bytes, named path
+//   update <length> <path>\n<bytes>    same, for the next version of an
+//                                      edited buffer
+//
+// and every request is answered with one line of JSON:
+//
+//   {"file":"a.cc","ok":true,"problems":true,"findings":[...]}
+//   {"file":"a.cc","ok":false,"error":"..."}
+//
+// where the findings are the records of the JSON Lines output (see
+// finding_writer.h). The main file is read anew for every request, but other
+// files included by a submission are cached like the system headers.
+//
+// For update, the server keeps the last version of each path and its
+// findings, and relints incrementally (see incremental_lint.h). An editor
+// sends update after every change; the first one lints the whole buffer.
+//
+// The socket has mode 0600, so only the user running the daemon can connect.
+// A request line longer than 64 KB is answered with an error and closes the
+// connection.
+//------------------------------------------------------------------------------
+#ifndef COMPETITIVE_LINT_LINT_SERVER_H
+#define COMPETITIVE_LINT_LINT_SERVER_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "clang/Basic/FileManager.h"
+
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+
+#include "incremental_lint.h"
+#include "lint_runner.h"
+
+namespace complint {
+
+class Connection;
+
+class LintServer {
+public:
+  LintServer(const LintRunner &runner, std::string socketPath)
+      : runner(runner), socketPath(std::move(socketPath)) {}
+
+  // Serves on threadCount workers until the process is terminated. Returns
+  // false and sets error if the socket can't be set up.
+  bool run(unsigned threadCount, std::string &error);
+
+private:
+  const LintRunner &runner;
+  std::string socketPath;
+
+  // The sessions of the update requests by path, the least recently used
+  // ones evicted beyond MAX_SESSIONS.
+  struct SessionEntry {
+    std::shared_ptr<LintSession> session;
+    uint64_t lastUse = 0;
+  };
+  std::mutex sessionsMutex;
+  llvm::StringMap<SessionEntry> sessions;
+  uint64_t useCount = 0;
+
+  std::shared_ptr<LintSession> getSession(llvm::StringRef path);
+  void work(int listener);
+  void serve(int connection, clang::FileManager &fileManager);
+  std::string handleRequest(Connection &connection,
+                            llvm::StringRef request,
+                            clang::FileManager &fileManager, bool &keepOpen);
+};
+
+} // namespace complint
+
+#endif // COMPETITIVE_LINT_LINT_SERVER_H
@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------------
+// Printing of the lint statistics.
+//------------------------------------------------------------------------------
+#include "lint_stats.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "llvm/Support/Format.h"
+
+#include "finding_writer.h"
+
+namespace complint {
+
+using namespace llvm;
+
+namespace {
+
+double toMilliseconds(double seconds) { return seconds * 1000; }
+
+double getMatchSeconds(const LintStats &stats, StringRef checker) {
+  auto it = stats.matchRecords.find(checker);
+  return it == stats.matchRecords.end() ? 0 : it->second.getWallTime();
+}
+
+} // namespace
+
+uint64_t getPeakRSSKilobytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+  return usage.ru_maxrss;
+}
+
+void LintStats::addNodeMatchRecords() {
+  for (const auto &entry : nodeMatchRecords) {
+    matchRecords[entry.getKey()] += entry.getValue();
+  }
+  nodeMatchRecords.clear();
+}
+
+void LintStats::print(raw_ostream &os, StringRef file) const {
+  // Sorted, so the output of different runs can be compared line by line.
+  std::vector<StringRef> names;
+  for (const auto &entry : checkers) {
+    names.push_back(entry.getKey());
+  }
+  std::sort(names.begin(), names.end());
+
+  if (format == Format::JSON) {
+    os << "{\"file\":";
+    writeJSONString(os, file);
+    os << llvm::format(",\"parse_ms\":%.3f", toMilliseconds(parseSeconds))
+       << llvm::format(",\"traversal_ms\":%.3f",
+                       toMilliseconds(traversalSeconds))
+       << llvm::format(",\"scan_ms\":%.3f", toMilliseconds(scanSeconds))
+       << ",\"scanned_bytes\":" << scannedBytes
+       << ",\"scanned_lines\":" << scannedLines
+       << ",\"scanned_comments\":" << scannedComments
+       << ",\"decls_visited\":" << declsVisited
+       << ",\"stmts_visited\":" << stmtsVisited
+       << ",\"decls_pruned\":" << declsPruned
+       << ",\"peak_rss_kb\":" << getPeakRSSKilobytes() << ",\"checkers\":[";
+    for (size_t i = 0; i < names.size(); ++i) {
+      const CheckerStats &checker = checkers.find(names[i])->second;
+      os << (i ? "," : "") << "{\"name\":";
+      writeJSONString(os, names[i]);
+      os << llvm::format(",\"source_ms\":%.3f",
+                         toMilliseconds(checker.sourceSeconds))
+         << llvm::format(",\"visit_ms\":%.3f",
+                         toMilliseconds(checker.visitSeconds))
+         << llvm::format(",\"match_ms\":%.3f",
+                         toMilliseconds(getMatchSeconds(*this, names[i])))
+         << ",\"matches\":" << checker.matches
+         << ",\"reports\":" << checker.reports << '}';
+    }
+    os << "]}\n";
+    return;
+  }
+
+  os << "lint statistics for " << file << ":\n"
+     << llvm::format("  parse and sema   %10.3f ms\n",
+                     toMilliseconds(parseSeconds))
+     << llvm::format("  traversal        %10.3f ms\n",
+                     toMilliseconds(traversalSeconds))
+     << llvm::format("  source scan      %10.3f ms  (%llu bytes, %u lines, "
+                     "%u comments)\n",
+                     toMilliseconds(scanSeconds),
+                     static_cast<unsigned long long>(scannedBytes),
+                     scannedLines, scannedComments)
+     << llvm::format("  visited          %llu declarations, %llu statements\n",
+                     static_cast<unsigned long long>(declsVisited),
+                     static_cast<unsigned long long>(stmtsVisited))
+     << llvm::format("  pruned           %llu declarations outside the main "
+                     "file\n",
+                     static_cast<unsigned long long>(declsPruned))
+     << llvm::format("  peak RSS         %llu KB\n",
+                     static_cast<unsigned long long>(getPeakRSSKilobytes()))
+     << llvm::format("  %-22s %10s %10s %10s %8s %8s\n", "checker",
+                     "source ms", "visit ms", "match ms", "matches",
+                     "reports");
+  for (StringRef name : names) {
+    const CheckerStats &checker = checkers.find(name)->second;
+    os << llvm::format("  %-22s %10.3f %10.3f %10.3f %8llu %8u\n",
+                       name.str().c_str(),
+                       toMilliseconds(checker.sourceSeconds),
+                       toMilliseconds(checker.visitSeconds),
+                       toMilliseconds(getMatchSeconds(*this, name)),
+                       static_cast<unsigned long long>(checker.matches),
+                       checker.reports);
+  }
+}
+
+} // namespace complint
@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+// Timing and counters of a lint run, to find out where the time goes.
+//
+// Enabled with the "stats" plugin argument (or "stats=json"). The time spent
+// in every checker is split into the text checks, the visit hooks and the
+// matchers; the latter is measured by the profiling of MatchFinder, per match
+// callback ID, next to the number of nodes the matchers of the checker
+// matched. Together with the parse time, the size of the scanned buffer, the
+// number of visited and pruned nodes and the peak RSS, it is printed to
+// stderr when the translation unit ends.
+//------------------------------------------------------------------------------
+#ifndef COMPETITIVE_LINT_LINT_STATS_H
+#define COMPETITIVE_LINT_LINT_STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace complint {
+
+struct CheckerStats {
+  double sourceSeconds = 0;
+  double visitSeconds = 0;
+  // Nodes matched by the matchers of the checker.
+  uint64_t matches = 0;
+  unsigned reports = 0;
+};
+
+struct LintStats {
+  enum class Format { Table, JSON };
+
+  explicit LintStats(Format format) : format(format) {}
+
+  Format format;
+
+  // From the start of the parse to the end of Sema.
+  double parseSeconds = 0;
+  double traversalSeconds = 0;
+  double scanSeconds = 0;
+
+  uint64_t scannedBytes = 0;
+  unsigned scannedLines = 0;
+  unsigned scannedComments = 0;
+
+  uint64_t declsVisited = 0;
+  uint64_t stmtsVisited = 0;
+  // Declarations skipped by MainFileTraversal, with everything inside them.
+  uint64_t declsPruned = 0;
+
+  llvm::StringMap<CheckerStats> checkers;
+  // Time of the matchers, keyed by the ID of the callbacks.
+  llvm::StringMap<llvm::TimeRecord> matchRecords;
+  // Filled by the MatchFinder profiling. Every call of match() replaces them
+  // with the time of its node, so they are added to matchRecords after each.
+  llvm::StringMap<llvm::TimeRecord> nodeMatchRecords;
+
+  // Adds nodeMatchRecords to matchRecords and clears them.
+  void addNodeMatchRecords();
+
+  void print(llvm::raw_ostream &os, llvm::StringRef file) const;
+};
+
+// Adds the time from its construction to its destruction to seconds, if
+// seconds isn't null.
+class ScopedStopwatch {
+public:
+  explicit ScopedStopwatch(double *seconds)
+      : seconds(seconds), start(seconds ? Clock::now() : Clock::time_point()) {
+  }
+  ~ScopedStopwatch() {
+    if (seconds) {
+      *seconds += std::chrono::duration<double>(Clock::now() - start).count();
+    }
+  }
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  double *seconds;
+  Clock::time_point start;
+};
+
+// Peak resident set size of the process, in kilobytes.
+uint64_t getPeakRSSKilobytes();
+
+} // namespace complint
+
+#endif // COMPETITIVE_LINT_LINT_STATS_H
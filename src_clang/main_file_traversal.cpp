@@ -0,0 +1,199 @@
+//------------------------------------------------------------------------------
+// Pruned traversal of the main-file declarations.
+//------------------------------------------------------------------------------
+#include "main_file_traversal.h"
+
+#include <algorithm>
+
+#include "clang/Lex/Lexer.h"
+
+namespace complint {
+
+using namespace clang;
+
+bool isRepeatedChild(const Stmt *loop, const Stmt *child) {
+  if (const auto *forStmt = dyn_cast<ForStmt>(loop)) {
+    return child != forStmt->getInit();
+  }
+  if (const auto *rangeFor = dyn_cast<CXXForRangeStmt>(loop)) {
+    return child == rangeFor->getBody() || child == rangeFor->getLoopVarStmt();
+  }
+  return isa<WhileStmt>(loop) || isa<DoStmt>(loop);
+}
+
+unsigned TraversalContext::getLoopDepth() const {
+  unsigned depth = 0;
+  for (size_t i = 0; i + 1 < stmtStack.size(); ++i) {
+    if (isRepeatedChild(stmtStack[i], stmtStack[i + 1])) {
+      ++depth;
+    }
+  }
+  return depth;
+}
+
+MainFileTraversal::MainFileTraversal(ASTContext &astContext,
+                                     CheckerList &checkers,
+                                     ast_matchers::MatchFinder &finder,
+                                     LintStats *stats, TraversalLimit *limit)
+    : astContext(astContext), checkers(checkers), finder(finder),
+      context(astContext), stats(stats), limit(limit) {
+  if (stats) {
+    for (auto &checker : checkers) {
+      checkerStats.push_back(&stats->checkers[checker->getName()]);
+    }
+  }
+}
+
+void MainFileTraversal::run() {
+  if (limit) {
+    for (auto &checker : checkers) {
+      if (checker->isProgramWide()) {
+        limit->programWideCheckers.push_back(checker->getName().str());
+      }
+    }
+    limit->traversedAll = !isLimitInFunctionBody();
+  }
+  // Declarations of a precompiled header are never in the main file, so the
+  // ones which aren't loaded yet can be skipped without loading them.
+  for (Decl *decl : astContext.getTranslationUnitDecl()->noload_decls()) {
+    if (!limit || limit->traversedAll || isWithinLimit(decl)) {
+      TraverseDecl(decl);
+    }
+  }
+}
+
+bool MainFileTraversal::TraverseDecl(Decl *decl) {
+  if (!decl) {
+    return true;
+  }
+  if (!isInMainFile(decl)) {
+    if (stats) {
+      ++stats->declsPruned;
+    }
+    return true;
+  }
+  const auto *function = dyn_cast<FunctionDecl>(decl);
+  if (!function || !function->doesThisDeclarationHaveABody()) {
+    return Base::TraverseDecl(decl);
+  }
+
+  // Statements of an enclosing function, e.g. around a local class, don't
+  // enclose the statements of this one.
+  const FunctionDecl *outerFunction = context.function;
+  std::vector<const Stmt *> outerStack;
+  outerStack.swap(context.stmtStack);
+  context.function = function;
+  bool result = Base::TraverseDecl(decl);
+  context.function = outerFunction;
+  context.stmtStack.swap(outerStack);
+  return result;
+}
+
+bool MainFileTraversal::TraverseStmt(Stmt *stmt) {
+  if (!stmt) {
+    return true;
+  }
+  context.stmtStack.push_back(stmt);
+  bool result = Base::TraverseStmt(stmt);
+  context.stmtStack.pop_back();
+  return result;
+}
+
+bool MainFileTraversal::VisitDecl(Decl *decl) {
+  finder.match(*decl, astContext);
+  if (stats) {
+    ++stats->declsVisited;
+    stats->addNodeMatchRecords();
+  }
+  for (size_t i = 0; i < checkers.size(); ++i) {
+    ScopedStopwatch stopwatch(getVisitSeconds(i));
+    checkers[i]->visitDecl(decl, context);
+  }
+  return true;
+}
+
+bool MainFileTraversal::VisitStmt(Stmt *stmt) {
+  finder.match(*stmt, astContext);
+  if (stats) {
+    ++stats->stmtsVisited;
+    stats->addNodeMatchRecords();
+  }
+  for (size_t i = 0; i < checkers.size(); ++i) {
+    ScopedStopwatch stopwatch(getVisitSeconds(i));
+    checkers[i]->visitStmt(stmt, context);
+  }
+  return true;
+}
+
+bool MainFileTraversal::isInMainFile(const Decl *decl) const {
+  SourceLocation location = decl->getLocStart();
+  if (location.isInvalid()) {
+    return false;
+  }
+  auto &sourceManager = astContext.getSourceManager();
+  return sourceManager.isInMainFile(sourceManager.getExpansionLoc(location));
+}
+
+bool MainFileTraversal::isWithinLimit(const Decl *decl) {
+  if (!isInMainFile(decl)) {
+    return false;
+  }
+  auto &sourceManager = astContext.getSourceManager();
+  SourceLocation begin = sourceManager.getExpansionLoc(decl->getLocStart());
+  SourceLocation end = sourceManager.getExpansionLoc(decl->getLocEnd());
+  unsigned beginOffset = sourceManager.getFileOffset(begin);
+  unsigned endOffset =
+      sourceManager.getFileOffset(end) +
+      Lexer::MeasureTokenLength(end, sourceManager, astContext.getLangOpts());
+  bool isNonLocal = std::any_of(
+      checkers.begin(), checkers.end(),
+      [&](const std::unique_ptr<Checker> &checker) {
+        return checker->isNonLocal(decl);
+      });
+  if (!isNonLocal &&
+      (endOffset < limit->begin || beginOffset > limit->end)) {
+    return false;
+  }
+  limit->traversedRanges.emplace_back(beginOffset, endOffset);
+  return true;
+}
+
+bool MainFileTraversal::isLimitInFunctionBody() const {
+  auto &sourceManager = astContext.getSourceManager();
+  for (Decl *decl : astContext.getTranslationUnitDecl()->noload_decls()) {
+    if (!isInMainFile(decl)) {
+      continue;
+    }
+    if (const auto *functionTemplate = dyn_cast<FunctionTemplateDecl>(decl)) {
+      decl = functionTemplate->getTemplatedDecl();
+    }
+    const auto *function = dyn_cast<FunctionDecl>(decl);
+    if (!function || !function->doesThisDeclarationHaveABody()) {
+      continue;
+    }
+    const auto *body = dyn_cast<CompoundStmt>(function->getBody());
+    SourceLocation lBrace =
+        body ? sourceManager.getExpansionLoc(body->getLBracLoc())
+             : SourceLocation();
+    SourceLocation rBrace =
+        body ? sourceManager.getExpansionLoc(body->getRBracLoc())
+             : SourceLocation();
+    if (lBrace.isInvalid() || rBrace.isInvalid() ||
+        !sourceManager.isInMainFile(lBrace) ||
+        limit->begin <= sourceManager.getFileOffset(lBrace) ||
+        limit->end > sourceManager.getFileOffset(rBrace)) {
+      continue;
+    }
+    // The body of a constexpr function or one with a deduced return type is
+    // part of how its callers are typed and evaluated.
+    return !function->isConstexpr() &&
+           !function->getDeclaredReturnType()->getContainedAutoType();
+  }
+  return false;
+}
+
+double *MainFileTraversal::getVisitSeconds(size_t checker) const {
+  return stats ? &checkerStats[checker]->visitSeconds : nullptr;
+}
+
+} // namespace complint
@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+// AST traversal restricted to the main file, shared by all checkers.
+//
+// With <bits/stdc++.h> included, nearly all of the AST comes from headers
+// which are never reported on. MainFileTraversal prunes every declaration
+// which doesn't start in the main file before descending into it, and runs the
+// checkers on what is left: their visit hooks and, node by node, their
+// matchers. Top-level declarations are taken from the local declaration list,
+// so nothing is deserialized from a precompiled header just to be skipped.
+//------------------------------------------------------------------------------
+#ifndef COMPETITIVE_LINT_MAIN_FILE_TRAVERSAL_H
+#define COMPETITIVE_LINT_MAIN_FILE_TRAVERSAL_H
+
+#include "clang/AST/RecursiveASTVisitor.h"
+
+#include "checker.h"
+#include "lint_stats.h"
+
+namespace complint {
+
+// Restricts MainFileTraversal to the top-level declarations which overlap the
+// byte range [begin, end] of the main file, e.g. the part of a buffer edited
+// since the previous run, and to those which a checker needs to see anyway
+// (see Checker::isNonLocal). The ranges of the declarations which were
+// traversed are recorded, so the findings in all others can be reused, as
+// are the names of the checkers which reported all their findings again
+// (see Checker::isProgramWide).
+//
+// The range is only kept if it lies within the body of a single function,
+// which can't change how the rest of the file is typed or evaluated. Anything
+// else, e.g. a typedef, a constant or a class, can, so then everything is
+// traversed and traversedAll is set.
+struct TraversalLimit {
+  unsigned begin = 0;
+  unsigned end = 0;
+  bool traversedAll = false;
+  std::vector<std::pair<unsigned, unsigned>> traversedRanges;
+  std::vector<std::string> programWideCheckers;
+};
+
+// Whether child runs on every iteration of the loop statement. False if loop
+// isn't one.
+bool isRepeatedChild(const clang::Stmt *loop, const clang::Stmt *child);
+
+class MainFileTraversal
+    : public clang::RecursiveASTVisitor<MainFileTraversal> {
+public:
+  // Counts the nodes and times the visit hooks in stats, if not null.
+  MainFileTraversal(clang::ASTContext &astContext, CheckerList &checkers,
+                    clang::ast_matchers::MatchFinder &finder,
+                    LintStats *stats = nullptr,
+                    TraversalLimit *limit = nullptr);
+
+  // Traverses the main-file part of the translation unit.
+  void run();
+
+  bool TraverseDecl(clang::Decl *decl);
+  bool TraverseStmt(clang::Stmt *stmt);
+
+  bool VisitDecl(clang::Decl *decl);
+  bool VisitStmt(clang::Stmt *stmt);
+
+private:
+  typedef clang::RecursiveASTVisitor<MainFileTraversal> Base;
+
+  bool isInMainFile(const clang::Decl *decl) const;
+  bool isWithinLimit(const clang::Decl *decl);
+  bool isLimitInFunctionBody() const;
+  double *getVisitSeconds(size_t checker) const;
+
+  clang::ASTContext &astContext;
+  CheckerList &checkers;
+  clang::ast_matchers::MatchFinder &finder;
+  TraversalContext context;
+  LintStats *stats;
+  TraversalLimit *limit;
+  // The statistics of every checker, in the order of checkers.
+  std::vector<CheckerStats *> checkerStats;
+};
+
+} // namespace complint
+
+#endif // COMPETITIVE_LINT_MAIN_FILE_TRAVERSAL_H
@@ -0,0 +1,219 @@
+//------------------------------------------------------------------------------
+// Prologue detection and the precompiled header cache.
+//------------------------------------------------------------------------------
+#include "pch_cache.h"
+
+#include <cstdlib>
+
+#include "clang/Basic/FileManager.h"
+#include "clang/Basic/Version.h"
+#include "clang/Frontend/FrontendActions.h"
+#include "clang/Tooling/Tooling.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace complint {
+
+using namespace clang;
+
+Prologue detectPrologue(StringRef source) {
+  Prologue prologue;
+  StringRef rest = source;
+  while (!rest.empty()) {
+    rest = rest.ltrim();
+    if (rest.startswith("/*")) {
+      size_t end = rest.find("*/", 2);
+      if (end == StringRef::npos) {
+        break;
+      }
+      rest = rest.drop_front(end + 2);
+      continue;
+    }
+
+    std::pair<StringRef, StringRef> lines = rest.split('\n');
+    StringRef line = lines.first.rtrim();
+    rest = lines.second;
+    if (line.startswith("//")) {
+      continue;
+    }
+    if (!line.startswith("#")) {
+      break;
+    }
+
+    StringRef directive = line.drop_front().ltrim();
+    if (!directive.consume_front("include")) {
+      break;
+    }
+    StringRef target = directive.ltrim();
+    size_t close = target.find('>');
+    if (!target.startswith("<") || close == StringRef::npos) {
+      break;
+    }
+    StringRef trailing = target.drop_front(close + 1).ltrim();
+    if (!trailing.empty() && !trailing.startswith("//")) {
+      break;
+    }
+    prologue.headers.push_back(target.slice(1, close).str());
+  }
+  return prologue;
+}
+
+std::string getDefaultCacheDirectory() {
+  if (const char *directory = std::getenv("COMP_LINT_CACHE_DIR")) {
+    return directory;
+  }
+  SmallString<128> path;
+  if (!llvm::sys::path::home_directory(path)) {
+    return "";
+  }
+  llvm::sys::path::append(path, ".cache", "comp-lint");
+  return path.str();
+}
+
+PCHCache::PCHCache(std::string directory, std::string clangPath,
+                   std::vector<std::string> compileArgs)
+    : directory(std::move(directory)), clangPath(std::move(clangPath)),
+      compileArgs(std::move(compileArgs)) {}
+
+std::string PCHCache::getPCHFor(StringRef source) {
+  Prologue prologue = detectPrologue(source);
+  if (prologue.empty() || directory.empty()) {
+    return "";
+  }
+
+  std::string key = computeKey(prologue);
+  Entry &entry = getEntry(key);
+  std::lock_guard<std::mutex> lock(entry.mutex);
+  if (!entry.resolved) {
+    entry.pchPath = lookupOrBuild(key, prologue);
+    entry.resolved = true;
+  }
+  return entry.pchPath;
+}
+
+void PCHCache::markUnusable(StringRef source) {
+  Prologue prologue = detectPrologue(source);
+  if (prologue.empty() || directory.empty()) {
+    return;
+  }
+
+  std::string key = computeKey(prologue);
+  Entry &entry = getEntry(key);
+  std::lock_guard<std::mutex> lock(entry.mutex);
+  if (entry.resolved && entry.pchPath.empty()) {
+    return;
+  }
+  entry.pchPath.clear();
+  entry.resolved = true;
+  writeFailedMarker(key);
+}
+
+PCHCache::Entry &PCHCache::getEntry(const std::string &key) {
+  std::lock_guard<std::mutex> lock(mutex);
+  std::unique_ptr<Entry> &entry = entries[key];
+  if (!entry) {
+    entry = llvm::make_unique<Entry>();
+  }
+  return *entry;
+}
+
+std::string PCHCache::computeKey(const Prologue &prologue) const {
+  const StringRef separator("\0", 1);
+  llvm::MD5 hash;
+  hash.update(getClangFullVersion());
+  hash.update(separator);
+  hash.update(clangPath);
+  for (const auto &arg : compileArgs) {
+    hash.update(separator);
+    hash.update(arg);
+  }
+  for (const auto &header : prologue.headers) {
+    hash.update(separator);
+    hash.update(header);
+  }
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  SmallString<32> key;
+  llvm::MD5::stringifyResult(result, key);
+  return key.str();
+}
+
+std::string PCHCache::lookupOrBuild(const std::string &key,
+                                    const Prologue &prologue) {
+  SmallString<128> pchPath(directory);
+  llvm::sys::path::append(pchPath, key + ".pch");
+  SmallString<128> failedPath(directory);
+  llvm::sys::path::append(failedPath, key + ".failed");
+
+  // The marker is checked first, as it is also written for a PCH which was
+  // built but couldn't be loaded.
+  if (llvm::sys::fs::exists(failedPath)) {
+    return "";
+  }
+  if (llvm::sys::fs::exists(pchPath)) {
+    return pchPath.str();
+  }
+  if (llvm::sys::fs::create_directories(directory)) {
+    return "";
+  }
+
+  // The PCH remembers the modification time of the header it was built
+  // from, so the header is created once and never rewritten: a unique file
+  // is linked into place, and a concurrent process which loses the race
+  // just uses the winner's identical copy.
+  SmallString<128> headerPath(directory);
+  llvm::sys::path::append(headerPath, key + ".h");
+  if (!llvm::sys::fs::exists(headerPath)) {
+    int fd;
+    SmallString<128> tempPath;
+    if (llvm::sys::fs::createUniqueFile(Twine(headerPath) + "-%%%%%%",
+                                        fd, tempPath)) {
+      return "";
+    }
+    {
+      llvm::raw_fd_ostream header(fd, /*shouldClose=*/true);
+      for (const auto &included : prologue.headers) {
+        header << "#include <" << included << ">\n";
+      }
+    }
+    llvm::sys::fs::create_hard_link(tempPath, headerPath);
+    llvm::sys::fs::remove(tempPath);
+  }
+
+  if (!build(headerPath, pchPath)) {
+    writeFailedMarker(key);
+    return "";
+  }
+  return pchPath.str();
+}
+
+void PCHCache::writeFailedMarker(const std::string &key) {
+  SmallString<128> failedPath(directory);
+  llvm::sys::path::append(failedPath, key + ".failed");
+  std::error_code error;
+  llvm::raw_fd_ostream marker(failedPath, error, llvm::sys::fs::F_None);
+}
+
+bool PCHCache::build(StringRef headerPath, StringRef pchPath) {
+  std::vector<std::string> args = {clangPath, "-x", "c++-header"};
+  args.insert(args.end(), compileArgs.begin(), compileArgs.end());
+  args.push_back(headerPath.str());
+  args.push_back("-o");
+  args.push_back(pchPath.str());
+
+  // GeneratePCHAction writes to a temporary file and renames it, so other
+  // processes never see a partially written PCH.
+  IntrusiveRefCntPtr<FileManager> fileManager(
+      new FileManager(FileSystemOptions()));
+  IgnoringDiagConsumer diagnostics;
+  tooling::ToolInvocation invocation(std::move(args), new GeneratePCHAction(),
+                                     fileManager.get());
+  invocation.setDiagnosticConsumer(&diagnostics);
+  return invocation.run();
+}
+
+} // namespace complint
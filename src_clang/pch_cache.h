@@ -0,0 +1,82 @@
+//------------------------------------------------------------------------------
+// On-disk cache of precompiled headers for submission prologues.
+//
+// Almost every submission starts with the same block of system includes
+// (usually just <bits/stdc++.h>), and parsing those headers costs far more
+// than checking the user code after them. The cache precompiles each distinct
+// prologue once and lints later files with -include-pch. The includes in the
+// main file are still processed, but the header guards restored from the PCH
+// make them no-ops, and the main-file text seen by the checkers is unchanged.
+//------------------------------------------------------------------------------
+#ifndef COMPETITIVE_LINT_PCH_CACHE_H
+#define COMPETITIVE_LINT_PCH_CACHE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "llvm/ADT/StringRef.h"
+
+namespace complint {
+
+// The leading block of `#include <...>` lines of a file. Only blank lines and
+// comments may appear between them.
+struct Prologue {
+  std::vector<std::string> headers;
+
+  bool empty() const { return headers.empty(); }
+};
+
+Prologue detectPrologue(llvm::StringRef source);
+
+// Directory of the linter caches: $COMP_LINT_CACHE_DIR or ~/.cache/comp-lint.
+std::string getDefaultCacheDirectory();
+
+class PCHCache {
+public:
+  // compileArgs are the compiler arguments the PCH will be used with; they
+  // have to match, so they are part of the cache key.
+  PCHCache(std::string directory, std::string clangPath,
+           std::vector<std::string> compileArgs);
+
+  // Returns the PCH for the prologue of source, building it on the first
+  // request. Returns an empty string if source has no prologue or the PCH
+  // can't be built, in which case the file is linted without one.
+  std::string getPCHFor(llvm::StringRef source);
+
+  // Marks the PCH for the prologue of source as failed after the compiler
+  // couldn't load it, e.g. because it is truncated or its headers changed
+  // since it was built. Later lookups return an empty string, like for a PCH
+  // which failed to build.
+  void markUnusable(llvm::StringRef source);
+
+private:
+  // The lookup of one key. Only the lookups of the same prologue wait for
+  // each other while its PCH is built.
+  struct Entry {
+    std::mutex mutex;
+    bool resolved = false;
+    std::string pchPath;
+  };
+
+  std::string directory;
+  std::string clangPath;
+  std::vector<std::string> compileArgs;
+
+  // Results of the lookups done by this process, by key. The mutex guards
+  // only the map, not the entries.
+  std::mutex mutex;
+  std::map<std::string, std::unique_ptr<Entry>> entries;
+
+  std::string computeKey(const Prologue &prologue) const;
+  Entry &getEntry(const std::string &key);
+  std::string lookupOrBuild(const std::string &key, const Prologue &prologue);
+  bool build(llvm::StringRef headerPath, llvm::StringRef pchPath);
+  void writeFailedMarker(const std::string &key);
+};
+
+} // namespace complint
+
+#endif // COMPETITIVE_LINT_PCH_CACHE_H
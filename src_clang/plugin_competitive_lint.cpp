@@ -0,0 +1,31 @@
+//------------------------------------------------------------------------------
+// Clang plugin running all competitive-linter checks in one pass.
+//
+// The text checks share one read of the main-file buffer and the AST checks
+// share one traversal of the translation unit. For example:
+//
+// $ clang++ -fsyntax-only \
+//      -Xclang -load -Xclang build/plugin_competitive_lint.so \
+//      -Xclang -add-plugin -Xclang competitive_lint test.cc
+//------------------------------------------------------------------------------
+#include "clang/Frontend/FrontendPluginRegistry.h"
+
+#include "checker.h"
+#include "lint_consumer.h"
+
+namespace {
+
+using namespace clang;
+using namespace complint;
+
+class CompetitiveLintAction : public LintPluginAction {
+protected:
+  CheckerList createCheckers() override {
+    return createAllCheckers();
+  }
+};
+
+}
+
+static FrontendPluginRegistry::Add<CompetitiveLintAction>
+    X("competitive_lint", "Runs all competitive programming checks in one pass.");
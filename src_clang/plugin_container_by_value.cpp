@@ -0,0 +1,35 @@
+//------------------------------------------------------------------------------
+// Clang plugin running only the container_by_value check.
+//
+// Once the .so is built, it can be loaded by Clang. For example:
+//
+// $ clang++ -fsyntax-only \
+//      -Xclang -load -Xclang build/plugin_container_by_value.so \
+//      -Xclang -plugin -Xclang container_by_value test.cc
+//
+// To run all checks with one traversal use plugin_competitive_lint.so instead.
+//------------------------------------------------------------------------------
+#include "clang/Frontend/FrontendPluginRegistry.h"
+
+#include "checker.h"
+#include "lint_consumer.h"
+
+namespace {
+
+using namespace clang;
+using namespace complint;
+
+class CheckContainerByValueAction : public LintPluginAction {
+protected:
+  CheckerList createCheckers() override {
+    CheckerList checkers;
+    checkers.push_back(createContainerByValueChecker());
+    return checkers;
+  }
+};
+
+}
+
+static FrontendPluginRegistry::Add<CheckContainerByValueAction>
+    X("container_by_value",
+      "Checks for containers passed by value instead of const reference.");
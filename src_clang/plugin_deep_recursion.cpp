@@ -0,0 +1,35 @@
+//------------------------------------------------------------------------------
+// Clang plugin running only the deep_recursion check.
+//
+// Once the .so is built, it can be loaded by Clang. For example:
+//
+// $ clang++ -fsyntax-only \
+//      -Xclang -load -Xclang build/plugin_deep_recursion.so \
+//      -Xclang -plugin -Xclang deep_recursion test.cc
+//
+// To run all checks with one traversal use plugin_competitive_lint.so instead.
+//------------------------------------------------------------------------------
+#include "clang/Frontend/FrontendPluginRegistry.h"
+
+#include "checker.h"
+#include "lint_consumer.h"
+
+namespace {
+
+using namespace clang;
+using namespace complint;
+
+class CheckDeepRecursionAction : public LintPluginAction {
+protected:
+  CheckerList createCheckers() override {
+    CheckerList checkers;
+    checkers.push_back(createDeepRecursionChecker());
+    return checkers;
+  }
+};
+
+}
+
+static FrontendPluginRegistry::Add<CheckDeepRecursionAction>
+    X("deep_recursion",
+      "Checks for recursive functions with large stack frames.");
@@ -0,0 +1,34 @@
+//------------------------------------------------------------------------------
+// Clang plugin running only the flush_in_loop check.
+//
+// Once the .so is built, it can be loaded by Clang. For example:
+//
+// $ clang++ -fsyntax-only \
+//      -Xclang -load -Xclang build/plugin_flush_in_loop.so \
+//      -Xclang -plugin -Xclang flush_in_loop test.cc
+//
+// To run all checks with one traversal use plugin_competitive_lint.so instead.
+//------------------------------------------------------------------------------
+#include "clang/Frontend/FrontendPluginRegistry.h"
+
+#include "checker.h"
+#include "lint_consumer.h"
+
+namespace {
+
+using namespace clang;
+using namespace complint;
+
+class CheckFlushInLoopAction : public LintPluginAction {
+protected:
+  CheckerList createCheckers() override {
+    CheckerList checkers;
+    checkers.push_back(createFlushInLoopChecker());
+    return checkers;
+  }
+};
+
+}
+
+static FrontendPluginRegistry::Add<CheckFlushInLoopAction>
+    X("flush_in_loop", "Checks for output flushed in a loop.");
@@ -0,0 +1,35 @@
+//------------------------------------------------------------------------------
+// Clang plugin running only the input_volume check.
+//
+// Once the .so is built, it can be loaded by Clang. For example:
+//
+// $ clang++ -fsyntax-only \
+//      -Xclang -load -Xclang build/plugin_input_volume.so \
+//      -Xclang -plugin -Xclang input_volume test.cc
+//
+// To run all checks with one traversal use plugin_competitive_lint.so instead.
+//------------------------------------------------------------------------------
+#include "clang/Frontend/FrontendPluginRegistry.h"
+
+#include "checker.h"
+#include "lint_consumer.h"
+
+namespace {
+
+using namespace clang;
+using namespace complint;
+
+class CheckInputVolumeAction : public LintPluginAction {
+protected:
+  CheckerList createCheckers() override {
+    CheckerList checkers;
+    checkers.push_back(createInputVolumeChecker());
+    return checkers;
+  }
+};
+
+}
+
+static FrontendPluginRegistry::Add<CheckInputVolumeAction>
+    X("input_volume",
+      "Recommends a buffered reader for large inputs.");
@@ -0,0 +1,35 @@
+//------------------------------------------------------------------------------
+// Clang plugin running only the integer_math check.
+//
+// Once the .so is built, it can be loaded by Clang. For example:
+//
+// $ clang++ -fsyntax-only \
+//      -Xclang -load -Xclang build/plugin_integer_math.so \
+//      -Xclang -plugin -Xclang integer_math test.cc
+//
+// To run all checks with one traversal use plugin_competitive_lint.so instead.
+//------------------------------------------------------------------------------
+#include "clang/Frontend/FrontendPluginRegistry.h"
+
+#include "checker.h"
+#include "lint_consumer.h"
+
+namespace {
+
+using namespace clang;
+using namespace complint;
+
+class CheckIntegerMathAction : public LintPluginAction {
+protected:
+  CheckerList createCheckers() override {
+    CheckerList checkers;
+    checkers.push_back(createIntegerMathChecker());
+    return checkers;
+  }
+};
+
+}
+
+static FrontendPluginRegistry::Add<CheckIntegerMathAction>
+    X("integer_math",
+      "Checks for pow, sqrt and log2 of integers truncated to integers.");
@@ -0,0 +1,35 @@
+//------------------------------------------------------------------------------
+// Clang plugin running only the linear_in_loop check.
+//
+// Once the .so is built, it can be loaded by Clang. For example:
+//
+// $ clang++ -fsyntax-only \
+//      -Xclang -load -Xclang build/plugin_linear_in_loop.so \
+//      -Xclang -plugin -Xclang linear_in_loop test.cc
+//
+// To run all checks with one traversal use plugin_competitive_lint.so instead.
+//------------------------------------------------------------------------------
+#include "clang/Frontend/FrontendPluginRegistry.h"
+
+#include "checker.h"
+#include "lint_consumer.h"
+
+namespace {
+
+using namespace clang;
+using namespace complint;
+
+class CheckLinearInLoopAction : public LintPluginAction {
+protected:
+  CheckerList createCheckers() override {
+    CheckerList checkers;
+    checkers.push_back(createLinearInLoopChecker());
+    return checkers;
+  }
+};
+
+}
+
+static FrontendPluginRegistry::Add<CheckLinearInLoopAction>
+    X("linear_in_loop",
+      "Checks for operations of linear cost inside loops.");
@@ -0,0 +1,177 @@
+//------------------------------------------------------------------------------
+// On-disk result cache with LRU eviction.
+//------------------------------------------------------------------------------
+#include "result_cache.h"
+
+#include <algorithm>
+
+#include <sys/time.h>
+
+#include "llvm/Support/Chrono.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace complint {
+
+using namespace llvm;
+
+namespace {
+
+constexpr char ENTRY_HEADER[] = "comp-lint-result 2\n";
+
+struct CacheFile {
+  std::string path;
+  uint64_t size;
+  sys::TimePoint<> lastUsed;
+};
+
+std::vector<CacheFile> listCacheFiles(StringRef directory) {
+  std::vector<CacheFile> files;
+  std::error_code error;
+  for (sys::fs::recursive_directory_iterator it(directory, error), end;
+       it != end && !error; it.increment(error)) {
+    sys::fs::file_status status;
+    if (it->status(status) ||
+        status.type() != sys::fs::file_type::regular_file) {
+      continue;
+    }
+    files.push_back({it->path(), status.getSize(),
+                     status.getLastModificationTime()});
+  }
+  return files;
+}
+
+} // namespace
+
+std::string replayOutput(const LintResult &result, StringRef path) {
+  if (result.mainFile.empty() || result.mainFile == path) {
+    return result.output;
+  }
+
+  std::string output;
+  StringRef rest = result.output;
+  for (size_t found = rest.find(result.mainFile); found != StringRef::npos;
+       found = rest.find(result.mainFile)) {
+    output += rest.take_front(found);
+    output += path;
+    rest = rest.drop_front(found + result.mainFile.size());
+  }
+  output += rest;
+  return output;
+}
+
+ResultCache::ResultCache(std::string directory, uint64_t maxSize,
+                         std::string configuration)
+    : directory(std::move(directory)), maxSize(maxSize),
+      configuration(std::move(configuration)) {}
+
+std::string ResultCache::getEntryPath(StringRef source) const {
+  MD5 hash;
+  hash.update(configuration);
+  hash.update(StringRef("\0", 1));
+  hash.update(source);
+  MD5::MD5Result result;
+  hash.final(result);
+  SmallString<32> key;
+  MD5::stringifyResult(result, key);
+
+  // Entries are spread over 256 subdirectories to keep directories small.
+  SmallString<128> path(directory);
+  sys::path::append(path, key.substr(0, 2), key);
+  return path.str();
+}
+
+bool ResultCache::lookup(StringRef source, LintResult &result) {
+  std::string path = getEntryPath(source);
+  auto buffer = MemoryBuffer::getFile(path);
+  if (!buffer) {
+    return false;
+  }
+
+  StringRef data = (*buffer)->getBuffer();
+  LintResult entry;
+  if (!data.consume_front(ENTRY_HEADER) ||
+      !readString(data, entry.mainFile) ||
+      !readString(data, entry.output) ||
+      !readFindings(data, entry.findings)) {
+    return false;
+  }
+
+  // The modification time doubles as the last use for the eviction.
+  ::utimes(path.c_str(), nullptr);
+  result = std::move(entry);
+  return true;
+}
+
+void ResultCache::store(StringRef source, const LintResult &result) {
+  std::string path = getEntryPath(source);
+  if (sys::fs::create_directories(sys::path::parent_path(path))) {
+    return;
+  }
+
+  std::string data;
+  raw_string_ostream dataStream(data);
+  dataStream << ENTRY_HEADER;
+  writeString(dataStream, result.mainFile);
+  writeString(dataStream, result.output);
+  writeFindings(dataStream, result.findings);
+  dataStream.flush();
+
+  // Entries are renamed into place, so readers never see partial ones.
+  int fd;
+  SmallString<128> tempPath;
+  if (sys::fs::createUniqueFile(path + "-%%%%%%", fd, tempPath)) {
+    return;
+  }
+  {
+    raw_fd_ostream entry(fd, /*shouldClose=*/true);
+    entry << data;
+  }
+  if (sys::fs::rename(tempPath, path)) {
+    sys::fs::remove(tempPath);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!sizeKnown) {
+    for (const auto &file : listCacheFiles(directory)) {
+      currentSize += file.size;
+    }
+    sizeKnown = true;
+  } else {
+    currentSize += data.size();
+  }
+  if (currentSize > maxSize) {
+    evict();
+  }
+}
+
+void ResultCache::evict() {
+  std::vector<CacheFile> files = listCacheFiles(directory);
+  std::sort(files.begin(), files.end(),
+            [](const CacheFile &a, const CacheFile &b) {
+              return a.lastUsed < b.lastUsed;
+            });
+
+  uint64_t total = 0;
+  for (const auto &file : files) {
+    total += file.size;
+  }
+
+  // Shrink a bit below the limit, so the next stores don't evict again.
+  const uint64_t target = maxSize / 10 * 9;
+  for (const auto &file : files) {
+    if (total <= target) {
+      break;
+    }
+    if (!sys::fs::remove(file.path)) {
+      total -= file.size;
+    }
+  }
+  currentSize = total;
+}
+
+} // namespace complint
@@ -0,0 +1,61 @@
+//------------------------------------------------------------------------------
+// Content-addressed on-disk cache of lint results.
+//
+// Resubmissions and shared templates mean the same bytes are linted over and
+// over. An entry is keyed by a hash of the main-file buffer and of everything
+// else the result depends on (linter version, enabled checkers, compiler and
+// its arguments), so a hit is replayed without parsing at all. The cache is
+// bounded: when it grows over its size limit the least recently used entries
+// are removed.
+//------------------------------------------------------------------------------
+#ifndef COMPETITIVE_LINT_RESULT_CACHE_H
+#define COMPETITIVE_LINT_RESULT_CACHE_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "llvm/ADT/StringRef.h"
+
+#include "findings.h"
+
+namespace complint {
+
+struct LintResult {
+  std::vector<Finding> findings;
+  // The path the file had when it was linted, and the diagnostics as they
+  // were printed for it.
+  std::string mainFile;
+  std::string output;
+};
+
+// The printed diagnostics of result, for the same buffer at path.
+std::string replayOutput(const LintResult &result, llvm::StringRef path);
+
+class ResultCache {
+public:
+  ResultCache(std::string directory, uint64_t maxSize,
+              std::string configuration);
+
+  bool lookup(llvm::StringRef source, LintResult &result);
+  void store(llvm::StringRef source, const LintResult &result);
+
+private:
+  std::string directory;
+  uint64_t maxSize;
+  std::string configuration;
+
+  // Approximate size of the cache, computed on the first store. Other
+  // processes sharing the directory are only seen at the next eviction.
+  std::mutex mutex;
+  bool sizeKnown = false;
+  uint64_t currentSize = 0;
+
+  std::string getEntryPath(llvm::StringRef source) const;
+  void evict();
+};
+
+} // namespace complint
+
+#endif // COMPETITIVE_LINT_RESULT_CACHE_H
@@ -0,0 +1,216 @@
+//------------------------------------------------------------------------------
+// Single-pass scanner building the line table and the comment spans.
+//------------------------------------------------------------------------------
+#include "source_scan.h"
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "llvm/Support/MathExtras.h"
+
+namespace complint {
+
+using namespace llvm;
+
+namespace {
+
+bool isSpecial(char c) {
+  return c == '\n' || c == '/' || c == '*' || c == '"' || c == '\'' ||
+         c == '\\';
+}
+
+bool isIdentifierChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// Lexical state machine fed with the positions of the special characters
+// only. Everything else can't change the state.
+class Scanner {
+public:
+  Scanner(StringRef source, std::vector<unsigned> &lineStarts,
+          std::vector<CommentSpan> &comments)
+      : source(source), lineStarts(lineStarts), comments(comments) {}
+
+  void visit(size_t pos) {
+    char c = source[pos];
+    if (c == '\n') {
+      lineStarts.push_back(pos + 1);
+    }
+    if (pos < skipUntil) {
+      return;
+    }
+
+    switch (state) {
+    case State::Code:
+      visitCode(pos);
+      break;
+    case State::LineComment:
+      if (c == '\n' && !isContinuedLine(pos)) {
+        comments.push_back({unsigned(commentBegin), unsigned(pos), true});
+        state = State::Code;
+      }
+      break;
+    case State::BlockComment:
+      if (c == '*' && at(pos + 1) == '/') {
+        comments.push_back({unsigned(commentBegin), unsigned(pos + 2), false});
+        state = State::Code;
+        skipUntil = pos + 2;
+      }
+      break;
+    case State::String:
+    case State::Character:
+      if (c == '\\') {
+        skipUntil = pos + 2;
+      } else if (c == '\n' || c == (state == State::String ? '"' : '\'')) {
+        state = State::Code;
+      }
+      break;
+    }
+  }
+
+  void finish() {
+    if (state == State::LineComment || state == State::BlockComment) {
+      comments.push_back({unsigned(commentBegin), unsigned(source.size()),
+                          state == State::LineComment});
+    }
+  }
+
+private:
+  enum class State { Code, LineComment, BlockComment, String, Character };
+
+  StringRef source;
+  std::vector<unsigned> &lineStarts;
+  std::vector<CommentSpan> &comments;
+
+  State state = State::Code;
+  size_t commentBegin = 0;
+  // Characters before this position were consumed by an earlier one, e.g.
+  // the quote in \" or the second slash of //.
+  size_t skipUntil = 0;
+
+  char at(size_t pos) const { return pos < source.size() ? source[pos] : 0; }
+
+  // Start of the identifier or number which ends right before pos.
+  size_t tokenStart(size_t pos) const {
+    while (pos > 0 && isIdentifierChar(source[pos - 1])) {
+      --pos;
+    }
+    return pos;
+  }
+
+  // A backslash right before the line break continues a // comment.
+  bool isContinuedLine(size_t newline) const {
+    size_t last = newline;
+    if (last > 0 && source[last - 1] == '\r') {
+      --last;
+    }
+    return last > 0 && source[last - 1] == '\\';
+  }
+
+  void visitCode(size_t pos) {
+    char c = source[pos];
+    if (c == '/') {
+      char next = at(pos + 1);
+      if (next == '/' || next == '*') {
+        state = next == '/' ? State::LineComment : State::BlockComment;
+        commentBegin = pos;
+        skipUntil = pos + 2;
+      }
+    } else if (c == '"') {
+      StringRef prefix = source.slice(tokenStart(pos), pos);
+      if (prefix == "R" || prefix == "u8R" || prefix == "uR" ||
+          prefix == "UR" || prefix == "LR") {
+        skipRawString(pos);
+      } else {
+        state = State::String;
+      }
+    } else if (c == '\'') {
+      // A quote inside a number is a digit separator, as in 1'000'000.
+      size_t start = tokenStart(pos);
+      if (start == pos ||
+          !std::isdigit(static_cast<unsigned char>(source[start]))) {
+        state = State::Character;
+      }
+    }
+  }
+
+  void skipRawString(size_t quote) {
+    size_t open = source.find('(', quote + 1);
+    if (open == StringRef::npos) {
+      state = State::String;
+      return;
+    }
+    std::string terminator = ")" + source.slice(quote + 1, open).str() + "\"";
+    size_t close = source.find(terminator, open + 1);
+    skipUntil = close == StringRef::npos ? source.size()
+                                         : close + terminator.size();
+  }
+};
+
+} // namespace
+
+SourceScan::SourceScan(StringRef source) : source(source) {
+  lineStarts.push_back(0);
+  Scanner scanner(source, lineStarts, comments);
+
+  const char *data = source.data();
+  const size_t size = source.size();
+  size_t pos = 0;
+#ifdef __SSE2__
+  const __m128i newline = _mm_set1_epi8('\n');
+  const __m128i slash = _mm_set1_epi8('/');
+  const __m128i star = _mm_set1_epi8('*');
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i apostrophe = _mm_set1_epi8('\'');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  for (; pos + 16 <= size; pos += 16) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+    __m128i special = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, newline),
+                     _mm_cmpeq_epi8(chunk, slash)),
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, star),
+                     _mm_cmpeq_epi8(chunk, backslash)));
+    special = _mm_or_si128(special,
+                           _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                        _mm_cmpeq_epi8(chunk, apostrophe)));
+    unsigned mask = _mm_movemask_epi8(special);
+    while (mask != 0) {
+      scanner.visit(pos + countTrailingZeros(mask));
+      mask &= mask - 1;
+    }
+  }
+#endif
+  for (; pos < size; ++pos) {
+    if (isSpecial(data[pos])) {
+      scanner.visit(pos);
+    }
+  }
+  scanner.finish();
+}
+
+StringRef SourceScan::getLine(unsigned line) const {
+  unsigned begin = lineStarts[line];
+  unsigned end = isTerminated(line) ? lineStarts[line + 1] - 1 : source.size();
+  return source.slice(begin, end);
+}
+
+bool SourceScan::isTerminated(unsigned line) const {
+  return line + 1 < lineStarts.size();
+}
+
+bool SourceScan::isBlank(unsigned line) const {
+  return getLine(line).find_first_not_of(" \t\r\v\f") == StringRef::npos;
+}
+
+unsigned SourceScan::getLineOf(unsigned offset) const {
+  auto it = std::upper_bound(lineStarts.begin(), lineStarts.end(), offset);
+  return it - lineStarts.begin() - 1;
+}
+
+} // namespace complint
@@ -0,0 +1,57 @@
+//------------------------------------------------------------------------------
+// Line table and comment spans of a source buffer, built in one linear pass.
+//
+// The text checkers used to run backtracking regexes over the whole buffer,
+// some of them repeatedly. SourceScan looks at the buffer once: SSE2 compares
+// find the few characters that matter (newlines, slashes, stars, quotes and
+// backslashes) sixteen bytes at a time, and a small state machine turns them
+// into line starts and comment spans, skipping string and character literals.
+// The result is shared by all text checkers of a translation unit.
+//------------------------------------------------------------------------------
+#ifndef COMPETITIVE_LINT_SOURCE_SCAN_H
+#define COMPETITIVE_LINT_SOURCE_SCAN_H
+
+#include <vector>
+
+#include "llvm/ADT/StringRef.h"
+
+namespace complint {
+
+struct CommentSpan {
+  unsigned begin;
+  unsigned end;
+  // "//" comment as opposed to "/* */".
+  bool isLineComment;
+};
+
+class SourceScan {
+public:
+  explicit SourceScan(llvm::StringRef source);
+
+  llvm::StringRef getSource() const { return source; }
+
+  unsigned getLineCount() const { return lineStarts.size(); }
+  unsigned getLineStart(unsigned line) const { return lineStarts[line]; }
+  // Text of a line (0-based), without the line break.
+  llvm::StringRef getLine(unsigned line) const;
+  // Whether the line ends with a newline, rather than the end of the buffer.
+  bool isTerminated(unsigned line) const;
+  // Whether the line consists of whitespace only.
+  bool isBlank(unsigned line) const;
+  // The 0-based line containing offset.
+  unsigned getLineOf(unsigned offset) const;
+
+  const std::vector<CommentSpan> &getComments() const { return comments; }
+  llvm::StringRef getText(const CommentSpan &comment) const {
+    return source.slice(comment.begin, comment.end);
+  }
+
+private:
+  llvm::StringRef source;
+  std::vector<unsigned> lineStarts;
+  std::vector<CommentSpan> comments;
+};
+
+} // namespace complint
+
+#endif // COMPETITIVE_LINT_SOURCE_SCAN_H
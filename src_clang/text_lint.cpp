@@ -0,0 +1,74 @@
+//------------------------------------------------------------------------------
+// Text-only linting of a memory-mapped file.
+//------------------------------------------------------------------------------
+#include "text_lint.h"
+
+#include "clang/Basic/DiagnosticOptions.h"
+#include "clang/Basic/FileManager.h"
+#include "clang/Basic/LangOptions.h"
+#include "clang/Basic/SourceManager.h"
+
+#include "llvm/Support/MemoryBuffer.h"
+
+namespace complint {
+
+using namespace clang;
+
+bool lintSourceText(StringRef path, CheckerList &checkers,
+                    FindingCollector &collector) {
+  // Large files are memory-mapped instead of read.
+  auto buffer = llvm::MemoryBuffer::getFileOrSTDIN(path);
+  if (!buffer) {
+    return false;
+  }
+  lintSourceBuffer(std::move(*buffer), checkers, collector);
+  return true;
+}
+
+void lintSourceBuffer(std::unique_ptr<llvm::MemoryBuffer> buffer,
+                      CheckerList &checkers, FindingCollector &collector) {
+  IntrusiveRefCntPtr<DiagnosticIDs> diagnosticIDs(new DiagnosticIDs());
+  IntrusiveRefCntPtr<DiagnosticOptions> diagnosticOptions(
+      new DiagnosticOptions());
+  DiagnosticsEngine diagnostics(diagnosticIDs, diagnosticOptions.get(),
+                                &collector, /*ShouldOwnClient=*/false);
+  FileManager fileManager((FileSystemOptions()));
+  SourceManager sourceManager(diagnostics, fileManager);
+  diagnostics.setSourceManager(&sourceManager);
+
+  FileID file = sourceManager.createFileID(std::move(buffer));
+  sourceManager.setMainFileID(file);
+  SourceScan scan(sourceManager.getBufferData(file));
+
+  DiagnosticRegistry registry(diagnostics);
+  for (auto &checker : checkers) {
+    checker->registerDiagnostics(registry);
+  }
+  collector.setRegistry(&registry);
+
+  // Only used to print the diagnostics.
+  LangOptions langOptions;
+  langOptions.CPlusPlus = true;
+  langOptions.CPlusPlus11 = true;
+
+  collector.BeginSourceFile(langOptions, nullptr);
+  SourceLocation fileStart = sourceManager.getLocForStartOfFile(file);
+  for (auto &checker : checkers) {
+    checker->checkSource(diagnostics, sourceManager, file, scan);
+    if (!checker->checksComments()) {
+      continue;
+    }
+    // Without a preprocessor, the comments come from the scan.
+    for (const CommentSpan &comment : scan.getComments()) {
+      SourceRange range(fileStart.getLocWithOffset(comment.begin),
+                        fileStart.getLocWithOffset(comment.end));
+      checker->checkComment(diagnostics, sourceManager, range,
+                            scan.getText(comment));
+    }
+  }
+  collector.EndSourceFile();
+  collector.finish();
+  collector.setRegistry(nullptr);
+}
+
+} // namespace complint
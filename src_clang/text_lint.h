@@ -0,0 +1,33 @@
+//------------------------------------------------------------------------------
+// Runs the text and comment checkers without preprocessing or parsing.
+//
+// The main file is mapped into a SourceManager of its own and handed to the
+// checkers directly, so no header is ever opened and no Sema is created. This
+// takes microseconds, which is fast enough for as-you-type diagnostics.
+//------------------------------------------------------------------------------
+#ifndef COMPETITIVE_LINT_TEXT_LINT_H
+#define COMPETITIVE_LINT_TEXT_LINT_H
+
+#include "clang/Basic/Diagnostic.h"
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+#include "checker.h"
+#include "findings.h"
+
+namespace complint {
+
+// Lints the file at path, or stdin for "-", reporting to collector. Returns
+// false if the file can't be read.
+bool lintSourceText(llvm::StringRef path, CheckerList &checkers,
+                    FindingCollector &collector);
+
+// Lints a buffer which is already in memory. The diagnostics refer to it by
+// the identifier of the buffer.
+void lintSourceBuffer(std::unique_ptr<llvm::MemoryBuffer> buffer,
+                      CheckerList &checkers, FindingCollector &collector);
+
+} // namespace complint
+
+#endif // COMPETITIVE_LINT_TEXT_LINT_H
@@ -0,0 +1,156 @@
+import json, os, shutil, socket, subprocess, tempfile, time, unittest
+
+COMP_LINT = 'build/comp-lint'
+
+# The helper is only reached through main, so its findings have to follow
+# the edits of main.
+HELPER_CALLED = '''#include <cstdio>
+#include <iostream>
+using namespace std;
+
+void print(int n) {
+   printf("%d\\n", n);
+}
+
+int main() {
+   ios_base::sync_with_stdio(false);
+   cin.tie(NULL);
+   int n;
+   cin >> n;
+   print(n);
+}
+'''
+
+MAIN_EDITED = HELPER_CALLED.replace('   cin >> n;\n',
+                                    '   cin >> n;\n   n += 1;\n')
+
+CALL_REMOVED = MAIN_EDITED.replace('   print(n);\n', '')
+
+FLUSHED_IN_HELPER = '''#include <iostream>
+using namespace std;
+
+void print(int x) {
+   cout << x << endl;
+}
+
+int main() {
+   int n;
+   cin >> n;
+   for (int i = 0; i < n; ++i) {
+      print(i);
+   }
+}
+'''
+
+FLUSH_MAIN_EDITED = FLUSHED_IN_HELPER.replace('   cin >> n;\n',
+                                              '   cin >> n;\n   n *= 2;\n')
+
+FLUSH_INTERACTIVE = '// complint: interactive\n' + FLUSH_MAIN_EDITED
+
+# The marker in a string literal isn't a comment.
+FLUSH_MARKER_IN_STRING = FLUSH_MAIN_EDITED.replace(
+    '   int n;\n',
+    '   const char *note = "complint: interactive";\n   int n;\n')
+
+# The typedef is outside of main, but changes the type of y in it.
+TYPEDEF_FLOAT = '''typedef float real;
+
+int main() {
+   real y = 0;
+   return y;
+}
+'''
+
+TYPEDEF_DOUBLE = TYPEDEF_FLOAT.replace('typedef float', 'typedef double')
+
+
+class DaemonTest(unittest.TestCase):
+    def setUp(self):
+        if not os.path.exists(COMP_LINT):
+            self.skipTest('comp-lint is not built')
+        self.directory = tempfile.mkdtemp()
+        self.socket_path = os.path.join(self.directory, 'lint.sock')
+        env = dict(os.environ, COMP_LINT_CACHE_DIR=self.directory)
+        self.daemon = subprocess.Popen(
+            [COMP_LINT, '-serve=' + self.socket_path, '-no-pch', '-j', '1'],
+            env=env)
+        deadline = time.time() + 10
+        while not os.path.exists(self.socket_path):
+            if time.time() > deadline or self.daemon.poll() is not None:
+                self.fail('the daemon did not start')
+            time.sleep(0.05)
+        self.connection = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.connection.connect(self.socket_path)
+        self.responses = self.connection.makefile('rb')
+
+    def tearDown(self):
+        self.responses.close()
+        self.connection.close()
+        self.daemon.kill()
+        self.daemon.wait()
+        shutil.rmtree(self.directory)
+
+    def request(self, command, source):
+        data = source.encode('utf-8')
+        header = '{0} {1} a.cc\n'.format(command, len(data))
+        self.connection.sendall(header.encode('utf-8') + data)
+        response = json.loads(self.responses.readline().decode('utf-8'))
+        self.assertTrue(response['ok'], response)
+        return sorted((f['offset'], f['checker'], f['message'])
+                      for f in response['findings'])
+
+    def helper_findings(self, findings, source, checker='fast_cin'):
+        helper_end = source.index('int main')
+        return [f for f in findings
+                if f[1] == checker and f[0] < helper_end]
+
+    def test_update_edits_main(self):
+        first = self.request('update', HELPER_CALLED)
+        self.assertEqual(len(self.helper_findings(first, HELPER_CALLED)), 1)
+
+        edited = self.request('update', MAIN_EDITED)
+        self.assertEqual(edited, self.request('buffer', MAIN_EDITED))
+        self.assertEqual(len(self.helper_findings(edited, MAIN_EDITED)), 1)
+
+        removed = self.request('update', CALL_REMOVED)
+        self.assertEqual(removed, self.request('buffer', CALL_REMOVED))
+        self.assertEqual(self.helper_findings(removed, CALL_REMOVED), [])
+
+    def test_update_flush_in_helper(self):
+        first = self.request('update', FLUSHED_IN_HELPER)
+        self.assertEqual(len(self.helper_findings(
+            first, FLUSHED_IN_HELPER, 'flush_in_loop')), 1)
+
+        edited = self.request('update', FLUSH_MAIN_EDITED)
+        self.assertEqual(edited, self.request('buffer', FLUSH_MAIN_EDITED))
+        self.assertEqual(len(self.helper_findings(
+            edited, FLUSH_MAIN_EDITED, 'flush_in_loop')), 1)
+
+        # Only a comment is added, but it turns the check off.
+        interactive = self.request('update', FLUSH_INTERACTIVE)
+        self.assertEqual(interactive,
+                         self.request('buffer', FLUSH_INTERACTIVE))
+        self.assertEqual(self.helper_findings(
+            interactive, FLUSH_INTERACTIVE, 'flush_in_loop'), [])
+
+    def test_marker_in_string(self):
+        findings = self.request('update', FLUSH_MARKER_IN_STRING)
+        self.assertEqual(findings,
+                         self.request('buffer', FLUSH_MARKER_IN_STRING))
+        self.assertEqual(len(self.helper_findings(
+            findings, FLUSH_MARKER_IN_STRING, 'flush_in_loop')), 1)
+
+    def test_update_edits_typedef(self):
+        first = self.request('update', TYPEDEF_FLOAT)
+        self.assertIn('no_float', [f[1] for f in first])
+
+        edited = self.request('update', TYPEDEF_DOUBLE)
+        self.assertEqual(edited, self.request('buffer', TYPEDEF_DOUBLE))
+        self.assertNotIn('no_float', [f[1] for f in edited])
+
+        reverted = self.request('update', TYPEDEF_FLOAT)
+        self.assertEqual(reverted, self.request('buffer', TYPEDEF_FLOAT))
+
+
+if __name__ == '__main__':
+    unittest.main()
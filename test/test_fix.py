@@ -0,0 +1,65 @@
+import os, shutil, stat, subprocess, tempfile, unittest
+
+COMP_LINT = 'build/comp-lint'
+
+# The fix-its of no_float and of the outer comparison don't overlap; the
+# inner comparison is inside the outer one, so it is skipped.
+SOURCE = '''int main() {
+   float a = 1;
+   double b = 2, c = 3;
+   return a == (b == c ? 1 : 2);
+}
+'''
+
+
+class FixTest(unittest.TestCase):
+    def setUp(self):
+        if not os.path.exists(COMP_LINT):
+            self.skipTest('comp-lint is not built')
+        self.directory = tempfile.mkdtemp()
+        self.path = os.path.join(self.directory, 'a.cc')
+        with open(self.path, 'w') as file:
+            file.write(SOURCE)
+        os.chmod(self.path, 0o640)
+
+    def tearDown(self):
+        shutil.rmtree(self.directory)
+
+    def comp_lint(self, flag):
+        env = dict(os.environ, COMP_LINT_CACHE_DIR=self.directory)
+        return subprocess.run([COMP_LINT, flag, '-no-pch', self.path],
+                              stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                              env=env)
+
+    def read(self):
+        with open(self.path) as file:
+            return file.read()
+
+    def test_fix(self):
+        result = self.comp_lint('-fix')
+        self.assertIn(b'the fix-its of 2 findings in 1 files',
+                      result.stderr)
+        self.assertIn(b'skipped 1 overlapping ones', result.stderr)
+
+        fixed = self.read()
+        self.assertIn('   double a = 1;\n', fixed)
+        self.assertIn('   return abs(a - (', fixed)
+        self.assertIn(') < EPS;\n', fixed)
+        self.assertEqual(stat.S_IMODE(os.stat(self.path).st_mode), 0o640)
+
+    def test_fix_diff(self):
+        result = self.comp_lint('-fix-diff')
+        self.assertIn(b'skipped 1 overlapping ones', result.stderr)
+        self.assertEqual(self.read(), SOURCE)
+
+        diff = result.stdout.decode('utf-8').splitlines()
+        self.assertEqual(diff[:3], ['--- ' + self.path, '+++ ' + self.path,
+                                    '@@ -1,5 +1,5 @@'])
+        self.assertIn('-   float a = 1;', diff)
+        self.assertIn('+   double a = 1;', diff)
+        self.assertIn('-   return a == (b == c ? 1 : 2);', diff)
+        self.assertEqual(len([l for l in diff if l.startswith('+')]), 3)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,60 @@
+import json, os, subprocess, tempfile, unittest
+
+CLANG = 'clang-llvm/bin/clang++'
+PLUGIN = 'build/plugin_competitive_lint.so'
+
+# Two comparisons in different statements, so in different calls of match().
+TWO_COMPARISONS = '''int main() {
+   double a = 1, b = 2;
+   bool first = a == b;
+   bool second = a != b;
+   return first && second;
+}
+'''
+
+
+def comparisons(count):
+    lines = ['int main() {', '   double a = 1, b = 2;', '   int n = 0;']
+    lines += ['   n += a == b;'] * count
+    lines += ['   return n;', '}', '']
+    return '\n'.join(lines)
+
+
+class StatsTest(unittest.TestCase):
+    def setUp(self):
+        if not os.path.exists(CLANG) or not os.path.exists(PLUGIN):
+            self.skipTest('clang or the plugin is not built')
+
+    def stats(self, source, checker='floating_point_comp'):
+        with tempfile.NamedTemporaryFile('w', suffix='.cc') as file:
+            file.write(source)
+            file.flush()
+            result = subprocess.run(
+                [CLANG, '-fsyntax-only',
+                 '-Xclang', '-load', '-Xclang', PLUGIN,
+                 '-Xclang', '-add-plugin', '-Xclang', 'competitive_lint',
+                 '-Xclang', '-plugin-arg-competitive_lint',
+                 '-Xclang', 'stats=json', file.name],
+                stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+        line = [l for l in result.stderr.decode('utf-8').splitlines()
+                if l.startswith('{"file":')][-1]
+        return next(c for c in json.loads(line)['checkers']
+                    if c['name'] == checker)
+
+    def test_matches_in_different_nodes(self):
+        stats = self.stats(TWO_COMPARISONS)
+        self.assertEqual(stats['matches'], 2)
+        self.assertEqual(stats['reports'], 2)
+        self.assertGreater(stats['match_ms'], 0)
+
+    def test_match_time_is_summed(self):
+        # The time of the last node alone doesn't grow with the number of
+        # matched nodes.
+        few = self.stats(comparisons(2))
+        many = self.stats(comparisons(4000))
+        self.assertEqual(many['matches'], 4000)
+        self.assertGreater(many['match_ms'], 20 * few['match_ms'])
+
+
+if __name__ == '__main__':
+    unittest.main()